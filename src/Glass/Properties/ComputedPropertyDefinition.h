@@ -0,0 +1,48 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include "Glass/Properties/PropertyDefinition.h"
+#include "Glass/Properties/PropertyList.h"
+
+namespace Glass {
+	//! Subclass this template to define a property whose value is a function of other
+	//! properties of the same PropertyList, such as a text color derived from a background
+	//! color and a theme.
+	//!
+	//! Must conform to the following concept:
+	//!   std::string name
+	//!   static U::type compute(const Inputs::property_type::type&...)
+	//!
+	//! The value is computed when the property is first read, and cached.  Setting any input,
+	//! or recomputing an input that is itself computed, marks the property stale, and it is
+	//! only recomputed at its next GetProperty, so several inputs changing in a row cost one
+	//! computation.  Its signal fires, and its didSet is called, when it is recomputed to a
+	//! different value.  Computed properties can't be set directly.
+	//!
+	//! \param D The type inheriting from ComputedPropertyDefinition
+	//! \param U The PropertyType to use for this property
+	//! \param Inputs The properties `compute` is given, which must be in the same PropertyList
+	template <typename D, typename U, typename... Inputs>
+	class ComputedPropertyDefinition : public PropertyDefinition<D, U> {
+	public:
+		using inputs = PropertyList<Inputs...>;
+
+		//! The value until the property is first computed
+		static typename U::type defaultValue() { return typename U::type{}; }
+	};
+}
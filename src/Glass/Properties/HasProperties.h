@@ -15,57 +15,187 @@
 
 #pragma once
 
+#include <bitset>
+
 #include "Glass/Properties/HasPropertiesBase.h"
 #include "Glass/Properties/PropertyDefinition.h"
 #include "Glass/Properties/Private/CreateProperties.h"
+#include "Glass/Properties/Private/ValueEquality.h"
 #include "Glass/Properties/Private/getName.h"
 #include "Glass/Properties/PropertyList.h"
+#include "Glass/Properties/PropertySnapshot.h"
 
 
 namespace Glass {
+	template <typename U, typename L> class PropertyMorph;
+
 	//! Mixin for object that implement glass properties
 	//!
 	//! \param U Type inheriting from HasProperties<Ps,U>; must be a subclass of HasPropertiesBase
 	//! \param Ps PropertyList type representing the list of properties held by this class
 	template <typename U, typename Ps> class HasProperties {
 		static_assert(IsPropertyList<Ps>, "Ps must be a PropertyList");
+		template <typename V, typename L> friend class PropertyMorph;
 
 	public:
 		template <typename P>
 		std::enable_if_t<PropertyListHasType<Ps, P>, typename P::property_type::type>
 		GetProperty() const {
-			auto maybeValue =
-			    getPropertyHolder().template GetProperty<typename P::property_type::type>(
+			return GetPropertyRef<P>();
+		}
+
+		//! A reference to the value of P, to read it without copying.  The reference stays
+		//! valid until P is next set.
+		template <typename P>
+		std::enable_if_t<PropertyListHasType<Ps, P>, const typename P::property_type::type&>
+		GetPropertyRef() const {
+			if constexpr (Meta::IsComputedProperty<P>) {
+				updateComputedProperty<P>();
+			}
+			const auto* value =
+			    getPropertyHolder().template GetPropertyPointer<typename P::property_type::type>(
 			        Private::getName<P>());
-			ZASSERT(maybeValue);
-			return *maybeValue;
+			ZASSERT(value);
+			return *value;
 		}
 
 		template <typename P>
 		std::enable_if_t<PropertyListHasType<Ps, P>, void>
-		SetProperty(typename P::property_type::type value) {
+		SetProperty(const typename P::property_type::type& value) {
+			static_assert(!Meta::IsComputedProperty<P>, "Computed properties can't be set");
+			const auto success = getPropertyHolder().SetProperty(Private::getName<P>(), value);
+			ZASSERT(success);
+		}
+
+		template <typename P>
+		std::enable_if_t<PropertyListHasType<Ps, P>, void>
+		SetProperty(typename P::property_type::type&& value) {
+			static_assert(!Meta::IsComputedProperty<P>, "Computed properties can't be set");
 			const auto success =
-			    getPropertyHolder().template SetProperty(Private::getName<P>(), value);
+			    getPropertyHolder().SetProperty(Private::getName<P>(), std::move(value));
 			ZASSERT(success);
 		}
 
+		//! Set P, replacing its scratch space (see ScratchSpaceAndValue) with `scratchSpace`, as
+		//! deserializing P does
+		template <typename P>
+		std::enable_if_t<PropertyListHasType<Ps, P>, void>
+		SetPropertyAndScratchSpace(typename P::property_type::type&& value,
+		                           boost::any scratchSpace) {
+			static_assert(!Meta::IsComputedProperty<P>, "Computed properties can't be set");
+			getPropertyHolder().SetPropertyScratchSpaceAt(
+			    m_firstPropertyIndex + PropertyListPosition<Ps, P>, std::move(scratchSpace));
+			SetProperty<P>(std::move(value));
+		}
+
+		//! The scratch space of P, which is empty if its type doesn't use any
+		template <typename P>
+		std::enable_if_t<PropertyListHasType<Ps, P>, const boost::any&>
+		GetPropertyScratchSpace() const {
+			return getPropertyHolder().GetPropertyScratchSpaceAt(m_firstPropertyIndex +
+			                                                     PropertyListPosition<Ps, P>);
+		}
+
+		//! Set P to a value constructed from `args`
+		template <typename P, typename... Args>
+		std::enable_if_t<PropertyListHasType<Ps, P>, void> EmplaceProperty(Args&&... args) {
+			SetProperty<P>(typename P::property_type::type(std::forward<Args>(args)...));
+		}
+
+		//! Call `fn` with a mutable reference to the value of P, then fire P's didSet once.  Use
+		//! this to change part of a large value, like one element of a vector, without copying
+		//! the rest.
+		template <typename P, typename F>
+		std::enable_if_t<PropertyListHasType<Ps, P>, void> ModifyProperty(F&& fn) {
+			static_assert(!Meta::IsComputedProperty<P>, "Computed properties can't be set");
+			const auto success =
+			    getPropertyHolder().template ModifyProperty<typename P::property_type::type>(
+			        Private::getName<P>(), std::forward<F>(fn));
+			ZASSERT(success);
+		}
+
+		//! Which properties of Ps were set since the last call, by their position in Ps, and
+		//! clear them.  This lets renderers and serializers poll for changes without
+		//! connecting to every property's signal; HasPropertiesBase::GetPropertiesVersion
+		//! tells them cheaply whether polling is needed at all.  Stale computed properties are
+		//! recomputed first, so they are dirty if their inputs changed them.  L must be Ps, and
+		//! only needs to be given when U has more than one PropertyList.
+		template <typename L = Ps>
+		std::enable_if_t<std::is_same_v<L, Ps>, std::bitset<PropertyListSize<Ps>>> ConsumeDirty() {
+			updateComputedProperties(Ps{});
+			std::bitset<PropertyListSize<Ps>> dirty;
+			auto& holder = getPropertyHolder();
+			for (size_t i = 0; i < dirty.size(); ++i) {
+				dirty[i] = holder.ConsumeDirty(m_firstPropertyIndex + i);
+			}
+			return dirty;
+		}
+
+		//! Which properties of Ps were set after `version`, a value previously returned by
+		//! HasPropertiesBase::GetPropertiesVersion, by their position in Ps.  Unlike
+		//! ConsumeDirty this clears nothing, so independent pollers don't interfere.  Like
+		//! ConsumeDirty, it recomputes stale computed properties first.
+		template <typename L = Ps>
+		std::enable_if_t<std::is_same_v<L, Ps>, std::bitset<PropertyListSize<Ps>>>
+		GetChangedSince(uint64_t version) const {
+			updateComputedProperties(Ps{});
+			std::bitset<PropertyListSize<Ps>> changed;
+			const auto& holder = getPropertyHolder();
+			for (size_t i = 0; i < changed.size(); ++i) {
+				changed[i] = holder.GetPropertyVersion(m_firstPropertyIndex + i) > version;
+			}
+			return changed;
+		}
+
+		//! Which properties of Ps differ between this object and `other`, by their position in
+		//! Ps.  Values are compared directly with areValuesEqual where their type allows it,
+		//! which for trivially comparable types is a memcmp, and otherwise through the holder
+		//! (see SimplePropertyHolder::IsPropertyEqual).  Scratch spaces aren't compared.
+		template <typename L = Ps>
+		std::enable_if_t<std::is_same_v<L, Ps>, std::bitset<PropertyListSize<Ps>>>
+		DiffProperties(const U& other) const {
+			const HasProperties& otherProperties = other;
+			updateComputedProperties(Ps{});
+			otherProperties.updateComputedProperties(Ps{});
+			return diffProperties(otherProperties, Ps{});
+		}
+
+		//! The values of all properties of Ps, to give back to Restore later, for example to
+		//! switch between presets.
+		template <typename L = Ps>
+		std::enable_if_t<std::is_same_v<L, Ps>, PropertySnapshot<Ps>> Snapshot() const {
+			updateComputedProperties(Ps{});
+			return snapshot(std::make_index_sequence<PropertyListSize<Ps>>{});
+		}
+
+		//! Set all properties of Ps to the values in `snapshot`.  Only properties whose values
+		//! differ from the snapshot's are set, so only they fire signals and become dirty;
+		//! properties whose types can't be compared (see areValuesEqual) are always set.  Every
+		//! value is set before any signal fires, so handlers see the whole snapshot restored.
+		//! Computed properties aren't set from the snapshot; they are recomputed from their
+		//! restored inputs.
+		template <typename L = Ps>
+		std::enable_if_t<std::is_same_v<L, Ps>, void>
+		Restore(const PropertySnapshot<Ps>& snapshot) {
+			restore(snapshot, true);
+		}
 
 	protected:
 		HasProperties() {
 			static_assert(std::is_base_of<HasPropertiesBase, U>::value,
 			              "U must derive from HasPropertiesBase");
+			m_firstPropertyIndex = getPropertyHolder().GetPropertyCount();
 			createProperties(Ps{});
+			// Inputs mark their computed properties stale before any didSet runs, so that didSet
+			// handlers read up to date computed properties
+			connectComputedProperties(Ps{});
+			connectPropertySignals(Ps{});
 		}
 
 		void didSet(void*) {}
 
 	private:
 		template <typename P> void createProperty() {
-			constexpr bool shouldCallSetNeedsDisplay =
-			    Meta::HasSetNeedsDisplay<U> && Meta::IsDisplayProperty<U>;
-			constexpr bool shouldCallSetNeedsLayout =
-			    Meta::HasSetNeedsLayout<U> && Meta::IsLayoutProperty<U>;
-
 			auto defaultValue = Private::getDefaultValue<P>();
 			const auto success =
 			    getPropertyHolder().CreateProperty(Private::getName<P>(),
@@ -73,6 +203,19 @@ namespace Glass {
 			                                       std::move(defaultValue.value),
 			                                       std::move(defaultValue.scratchSpace));
 			ZASSERT(success);
+		}
+
+		template <typename... P> void createProperties(PropertyList<P...>) {
+			(createProperty<P>(), ...);
+		}
+
+		//! When P is set, call the didSet for P, SetNeedsLayout and SetNeedsDisplay that U has
+		template <typename P> void connectPropertySignal() {
+			constexpr bool shouldCallSetNeedsDisplay =
+			    Meta::HasSetNeedsDisplay<U> && Meta::IsDisplayProperty<U>;
+			constexpr bool shouldCallSetNeedsLayout =
+			    Meta::HasSetNeedsLayout<U> && Meta::IsLayoutProperty<U>;
+
 			if constexpr (Meta::HasDidSet<U, P> || shouldCallSetNeedsLayout ||
 			              shouldCallSetNeedsDisplay) {
 				getPropertyHolder()
@@ -91,8 +234,179 @@ namespace Glass {
 			}
 		}
 
-		template <typename... P> void createProperties(PropertyList<P...>) {
-			(createProperty<P>(), ...);
+		template <typename... P> void connectPropertySignals(PropertyList<P...>) {
+			(connectPropertySignal<P>(), ...);
+		}
+
+		template <typename P> bool isPropertyEqual(const HasProperties& other, size_t i) const {
+			if constexpr (Private::CanCompareValues_v<typename P::property_type::type>) {
+				return Private::areValuesEqual(GetPropertyRef<P>(), other.GetPropertyRef<P>());
+			} else {
+				return getPropertyHolder().IsPropertyEqual(m_firstPropertyIndex + i,
+				                                           other.getPropertyHolder(),
+				                                           other.m_firstPropertyIndex + i);
+			}
+		}
+
+		template <typename... P>
+		std::bitset<sizeof...(P)> diffProperties(const HasProperties& other,
+		                                         PropertyList<P...>) const {
+			std::bitset<sizeof...(P)> different;
+			size_t i = 0;
+			((different[i] = !isPropertyEqual<P>(other, i), ++i), ...);
+			return different;
+		}
+
+		template <typename... P> void connectComputedProperties(PropertyList<P...>) {
+			(connectComputedProperty<P>(), ...);
+		}
+
+		template <typename P> void connectComputedProperty() {
+			if constexpr (Meta::IsComputedProperty<P>) {
+				m_isComputedPropertyStale.set(PropertyListPosition<Ps, P>);
+				connectComputedPropertyInputs<P>(typename P::inputs{});
+			}
+		}
+
+		template <typename P, typename... Inputs>
+		void connectComputedPropertyInputs(PropertyList<Inputs...>) {
+			static_assert((PropertyListHasType<Ps, Inputs> && ...),
+			              "The inputs of a computed property must be in its PropertyList");
+			(getPropertyHolder()
+			     .GetPropertySignal(Private::getName<Inputs>())
+			     .Connect(&getTrackable(), [this] { markComputedPropertyStale<P>(); }),
+			 ...);
+		}
+
+		//! Mark P stale, along with every computed property that depends on it
+		template <typename P> void markComputedPropertyStale() {
+			constexpr auto position = PropertyListPosition<Ps, P>;
+			if (m_isComputedPropertyStale[position]) {
+				return;
+			}
+			m_isComputedPropertyStale.set(position);
+			markDependentPropertiesStale<P>(Ps{});
+		}
+
+		template <typename Input, typename... P>
+		void markDependentPropertiesStale(PropertyList<P...>) {
+			(
+			    [&] {
+				    if constexpr (Meta::IsComputedProperty<P>) {
+					    if constexpr (PropertyListHasType<typename P::inputs, Input>) {
+						    markComputedPropertyStale<P>();
+					    }
+				    }
+			    }(),
+			    ...);
+		}
+
+		//! Recompute P if it is stale
+		template <typename P> void updateComputedProperty() const {
+			using Value = typename P::property_type::type;
+			constexpr auto position = PropertyListPosition<Ps, P>;
+			if (!m_isComputedPropertyStale[position]) {
+				return;
+			}
+			// Reading the inputs may recompute them, which marks P stale again, so P is only
+			// marked up to date once they have been read
+			auto value = computeProperty<P>(typename P::inputs{});
+			m_isComputedPropertyStale.reset(position);
+
+			// Computing a property doesn't change the object as far as its users can tell, so
+			// it happens in const getters
+			auto& holder = const_cast<HasProperties*>(this)->getPropertyHolder();
+			const auto index = m_firstPropertyIndex + position;
+			if constexpr (Private::CanCompareValues_v<Value>) {
+				const auto* current = holder.template GetPropertyPointerAt<Value>(index);
+				ZASSERT(current);
+				if (Private::areValuesEqual(*current, value)) {
+					return;
+				}
+			}
+			const auto success = holder.SetDerivedPropertyAt(index, std::move(value));
+			ZASSERT(success);
+		}
+
+		template <typename P, typename... Inputs>
+		typename P::property_type::type computeProperty(PropertyList<Inputs...>) const {
+			return P::compute(GetPropertyRef<Inputs>()...);
+		}
+
+		template <typename... P> void updateComputedProperties(PropertyList<P...>) const {
+			(
+			    [&] {
+				    if constexpr (Meta::IsComputedProperty<P>) {
+					    updateComputedProperty<P>();
+				    }
+			    }(),
+			    ...);
+		}
+
+		template <size_t I>
+		using PropertyValueAt = std::tuple_element_t<I, typename PropertySnapshot<Ps>::Values>;
+
+		template <size_t... I> PropertySnapshot<Ps> snapshot(std::index_sequence<I...>) const {
+			const auto& holder = getPropertyHolder();
+			return PropertySnapshot<Ps>{
+			    {*holder.template GetPropertyPointerAt<PropertyValueAt<I>>(m_firstPropertyIndex +
+			                                                                I)...}};
+		}
+
+		//! Restore, recording the edits in the undo history only if `shouldRecordEdits` is true.
+		//! PropertyMorph doesn't, since a morph's values are derived from its snapshots.
+		void restore(const PropertySnapshot<Ps>& snapshot, bool shouldRecordEdits) {
+			restoreProperties(snapshot,
+			                  shouldRecordEdits,
+			                  Ps{},
+			                  std::make_index_sequence<PropertyListSize<Ps>>{});
+		}
+
+		template <typename... P, size_t... I>
+		void restoreProperties(const PropertySnapshot<Ps>& snapshot,
+		                       bool shouldRecordEdits,
+		                       PropertyList<P...>,
+		                       std::index_sequence<I...>) {
+			std::bitset<PropertyListSize<Ps>> changed;
+			(changed.set(I,
+			             restoreProperty<P, I>(std::get<I>(snapshot.values), shouldRecordEdits)),
+			 ...);
+			auto& holder = getPropertyHolder();
+			for (size_t i = 0; i < changed.size(); ++i) {
+				if (changed[i]) {
+					holder.FirePropertySignal(m_firstPropertyIndex + i);
+				}
+			}
+		}
+
+		//! Assign P, at position I, without firing its signal.  Returns whether it was assigned.
+		//! Computed properties aren't assigned, since they are recomputed from their inputs.  The
+		//! properties that depend on P are marked stale right away, so that the handlers of every
+		//! signal the restore fires read values computed from the restored inputs.
+		template <typename P, size_t I>
+		bool restoreProperty(const PropertyValueAt<I>& value, bool shouldRecordEdit) {
+			if constexpr (Meta::IsComputedProperty<P>) {
+				UNREF_PARAM(value);
+				UNREF_PARAM(shouldRecordEdit);
+				return false;
+			} else {
+				using Value = PropertyValueAt<I>;
+				auto& holder = getPropertyHolder();
+				const auto index = m_firstPropertyIndex + I;
+				if constexpr (Private::CanCompareValues_v<Value>) {
+					const auto* current = holder.template GetPropertyPointerAt<Value>(index);
+					ZASSERT(current);
+					if (Private::areValuesEqual(*current, value)) {
+						return false;
+					}
+				}
+				const auto success = holder.AssignPropertyAt(index, value, shouldRecordEdit);
+				ZASSERT(success);
+				if (success) {
+					markDependentPropertiesStale<P>(Ps{});
+				}
+				return success;
+			}
 		}
 
 		const SimplePropertyHolder& getPropertyHolder() const {
@@ -104,5 +418,11 @@ namespace Glass {
 		}
 
 		Trackable& getTrackable() { return static_cast<U*>(this)->HasPropertiesBase::m_trackable; }
+
+		//! The holder numbers properties in creation order, so the property at position i in Ps
+		//! is number m_firstPropertyIndex + i
+		size_t m_firstPropertyIndex = 0;
+		//! By position in Ps.  Only the bits of computed properties are used.
+		mutable std::bitset<PropertyListSize<Ps>> m_isComputedPropertyStale;
 	};
 }
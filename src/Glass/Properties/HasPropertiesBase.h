@@ -40,8 +40,19 @@ namespace Glass {
 		template <typename Ps, typename U> friend class HasProperties;
 		friend class ViewDesignInterface;
 		friend class HasToolTip;
+		friend class PropertyReplicator;
+		friend class PropertyAnimator;
 
 	public:
+		//! Incremented every time any property of this object is set
+		uint64_t GetPropertiesVersion() const { return m_propertyHolder->GetVersion(); }
+
+		//! Record edits of this object's properties in `history` (see
+		//! SimplePropertyHolder::SetUndoHistory)
+		void SetUndoHistory(PropertyUndoHistory* history) {
+			m_propertyHolder->SetUndoHistory(history);
+		}
+
 #ifdef IZ_INTERNAL_BUILD
 		void SetStyleSheet(shared_ptr<Util::StyleSheet> styleSheet);
 		//! Set classes that this object will use to pull properties from a given stylesheet. If
@@ -16,8 +16,10 @@
 #include "iZBase/common/common.h"
 
 #include "Glass/Properties/Types/Builtins.h"
+#include "Glass/Properties/ComputedPropertyDefinition.h"
 #include "Glass/Properties/HasProperties.h"
 #include "Glass/Properties/HasPropertiesBase.h"
+#include "Glass/Properties/SerializeProperties.h"
 #include "iZBase/Util/PropertySerializer.h"
 
 IZ_PUSH_ALL_WARNINGS
@@ -89,10 +91,22 @@ namespace {
 		using BackgroundColorMixin<TestClass>::GetProperty;
 		using Glass::HasProperties<TestClass, Properties>::SetProperty;
 		using BackgroundColorMixin<TestClass>::SetProperty;
-
-		void didSet(IntValue) { latestIntValue = GetProperty<IntValue>(); }
+		using Glass::HasProperties<TestClass, Properties>::ConsumeDirty;
+		using BackgroundColorMixin<TestClass>::ConsumeDirty;
+		using Glass::HasProperties<TestClass, Properties>::DiffProperties;
+		using BackgroundColorMixin<TestClass>::DiffProperties;
+		using Glass::HasProperties<TestClass, Properties>::Snapshot;
+		using BackgroundColorMixin<TestClass>::Snapshot;
+		using Glass::HasProperties<TestClass, Properties>::Restore;
+		using BackgroundColorMixin<TestClass>::Restore;
+
+		void didSet(IntValue) {
+			latestIntValue = GetProperty<IntValue>();
+			floatValueAtIntDidSet = GetProperty<FloatValue>();
+		}
 
 		std::optional<int32_t> latestIntValue;
+		std::optional<float> floatValueAtIntDidSet;
 		std::optional<Color> latestBackgroundColorValue;
 	};
 
@@ -148,6 +162,76 @@ TEST_F(HasPropertiesTests, Mixin) {
 	ASSERT_EQ(-2, p.GetProperty<IntValue2>());
 }
 
+TEST_F(HasPropertiesTests, ConsumeDirty) {
+	const auto version = p.GetPropertiesVersion();
+	ASSERT_TRUE(p.ConsumeDirty<Properties>().none());
+	ASSERT_TRUE(p.ConsumeDirty<BGProperties>().none());
+
+	p.SetProperty<FloatValue>(1.f);
+	p.SetProperty<IntValue2>(2);
+	ASSERT_EQ(version + 2, p.GetPropertiesVersion());
+	// Bits are positions in each PropertyList
+	ASSERT_EQ(std::bitset<2>{"10"}, p.ConsumeDirty<Properties>());
+	ASSERT_EQ(std::bitset<2>{"10"}, p.ConsumeDirty<BGProperties>());
+	ASSERT_TRUE(p.ConsumeDirty<Properties>().none());
+	ASSERT_TRUE(p.ConsumeDirty<BGProperties>().none());
+
+	p.SetProperty<IntValue>(3);
+	ASSERT_EQ(std::bitset<2>{"01"}, p.ConsumeDirty<Properties>());
+	ASSERT_EQ(version + 3, p.GetPropertiesVersion());
+}
+
+TEST_F(HasPropertiesTests, DiffProperties) {
+	TestClass other;
+	ASSERT_TRUE(p.DiffProperties<Properties>(other).none());
+	ASSERT_TRUE(p.DiffProperties<BGProperties>(other).none());
+
+	other.SetProperty<FloatValue>(1.f);
+	other.SetProperty<BackgroundColor>(Color{0.f, 0.f, 0.f});
+	// Bits are positions in each PropertyList
+	ASSERT_EQ(std::bitset<2>{"10"}, p.DiffProperties<Properties>(other));
+	ASSERT_EQ(std::bitset<2>{"01"}, p.DiffProperties<BGProperties>(other));
+
+	// Setting a property to an equal value doesn't make it differ
+	other.SetProperty<FloatValue>(EXPECTED_FLOAT);
+	p.SetProperty<IntValue>(EXPECTED_INT);
+	ASSERT_TRUE(p.DiffProperties<Properties>(other).none());
+}
+
+TEST_F(HasPropertiesTests, SnapshotAndRestore) {
+	const auto snapshot = p.Snapshot<Properties>();
+	ASSERT_EQ(EXPECTED_INT, snapshot.Get<IntValue>());
+	ASSERT_EQ(EXPECTED_FLOAT, snapshot.Get<FloatValue>());
+
+	p.SetProperty<IntValue>(1);
+	p.SetProperty<FloatValue>(2.f);
+	p.ConsumeDirty<Properties>();
+	p.latestIntValue.reset();
+	p.Restore(snapshot);
+	ASSERT_EQ(EXPECTED_INT, p.GetProperty<IntValue>());
+	ASSERT_EQ(EXPECTED_FLOAT, p.GetProperty<FloatValue>());
+	ASSERT_EQ(std::bitset<2>{"11"}, p.ConsumeDirty<Properties>());
+	ASSERT_EQ(EXPECTED_INT, p.latestIntValue);
+	// Every value is restored before any didSet is called, even for properties listed later
+	ASSERT_EQ(EXPECTED_FLOAT, p.floatValueAtIntDidSet);
+
+	// Only properties that differ from the snapshot are set
+	auto modified = snapshot;
+	modified.Set<FloatValue>(3.f);
+	p.latestIntValue.reset();
+	const auto version = p.GetPropertiesVersion();
+	p.Restore(modified);
+	ASSERT_EQ(3.f, p.GetProperty<FloatValue>());
+	ASSERT_EQ(std::bitset<2>{"10"}, p.ConsumeDirty<Properties>());
+	ASSERT_EQ(version + 1, p.GetPropertiesVersion());
+	ASSERT_FALSE(p.latestIntValue);
+	p.Restore(modified);
+	ASSERT_EQ(version + 1, p.GetPropertiesVersion());
+
+	// Other PropertyLists are untouched
+	ASSERT_TRUE(p.ConsumeDirty<BGProperties>().none());
+}
+
 #ifdef IZ_INTERNAL_BUILD
 TEST_F(HasPropertiesTests, BasicStylesheet) {
 	stylesheet->AddProperty(className, "IntValue", "Int", "5");
@@ -190,3 +274,245 @@ TEST_F(HasPropertiesTests, ClassPrecedence) {
 	EXPECT_EQ(5, p.GetProperty<IntValue>());
 }
 #endif
+
+namespace {
+	//! A vector of ints that counts its copies
+	struct CountedVector {
+		CountedVector() = default;
+		CountedVector(std::initializer_list<int32_t> values)
+		    : values{values} {}
+		CountedVector(size_t size, int32_t value)
+		    : values(size, value) {}
+		CountedVector(const CountedVector& other)
+		    : values{other.values} {
+			++copies;
+		}
+		CountedVector(CountedVector&&) = default;
+		CountedVector& operator=(const CountedVector& other) {
+			values = other.values;
+			++copies;
+			return *this;
+		}
+		CountedVector& operator=(CountedVector&&) = default;
+
+		vector<int32_t> values;
+		static inline size_t copies = 0;
+	};
+
+	struct CountedVectorPropertyType : Glass::PropertyType<CountedVector> {
+		static constexpr auto name = "CountedVector";
+	};
+
+	struct Items : Glass::PropertyDefinition<Items, CountedVectorPropertyType> {
+		static constexpr const char* const name = "Items";
+		static CountedVector defaultValue() { return CountedVector{1, 2, 3}; }
+	};
+
+	struct ItemsClass : public Glass::HasPropertiesBase,
+	                    public Glass::HasProperties<ItemsClass, Glass::PropertyList<Items>> {
+		void didSet(Items) { ++didSetCount; }
+
+		size_t didSetCount = 0;
+	};
+}
+
+TEST(HasPropertiesMutation, SetPropertyMovesRvalues) {
+	ItemsClass items;
+	CountedVector::copies = 0;
+	items.SetProperty<Items>(CountedVector{4, 5});
+	ASSERT_EQ(0u, CountedVector::copies);
+	ASSERT_EQ((vector<int32_t>{4, 5}), items.GetPropertyRef<Items>().values);
+
+	const CountedVector value{6};
+	items.SetProperty<Items>(value);
+	ASSERT_EQ(1u, CountedVector::copies);
+	ASSERT_EQ(2u, items.didSetCount);
+}
+
+TEST(HasPropertiesMutation, EmplaceProperty) {
+	ItemsClass items;
+	CountedVector::copies = 0;
+	items.EmplaceProperty<Items>(size_t{4}, 7);
+	ASSERT_EQ(0u, CountedVector::copies);
+	ASSERT_EQ((vector<int32_t>{7, 7, 7, 7}), items.GetPropertyRef<Items>().values);
+	ASSERT_EQ(1u, items.didSetCount);
+}
+
+TEST(HasPropertiesMutation, ModifyPropertyInPlace) {
+	ItemsClass items;
+	const auto* data = items.GetPropertyRef<Items>().values.data();
+	CountedVector::copies = 0;
+	items.ModifyProperty<Items>([](CountedVector& value) {
+		value.values[1] = 20;
+		value.values[2] = 30;
+	});
+	ASSERT_EQ(0u, CountedVector::copies);
+	ASSERT_EQ(1u, items.didSetCount);
+	ASSERT_EQ((vector<int32_t>{1, 20, 30}), items.GetPropertyRef<Items>().values);
+	ASSERT_EQ(data, items.GetPropertyRef<Items>().values.data());
+}
+
+TEST(HasPropertiesMutation, GetPropertyRefDoesntCopy) {
+	ItemsClass items;
+	CountedVector::copies = 0;
+	const auto& value = items.GetPropertyRef<Items>();
+	ASSERT_EQ(2, value.values[1]);
+	ASSERT_EQ(0u, CountedVector::copies);
+	items.GetProperty<Items>();
+	ASSERT_EQ(1u, CountedVector::copies);
+}
+
+TEST(HasPropertiesMutation, ModifyPropertyMarksDirty) {
+	ItemsClass items;
+	ASSERT_TRUE(items.ConsumeDirty().none());
+	items.ModifyProperty<Items>([](CountedVector& value) { value.values.push_back(4); });
+	ASSERT_TRUE(items.ConsumeDirty().all());
+	ASSERT_TRUE(items.ConsumeDirty().none());
+}
+
+namespace {
+	struct Theme : Glass::PropertyDefinition<Theme, Glass::IntPropertyType> {
+		static constexpr const char* const name = "Theme";
+		static constexpr int32_t defaultValue = 0;
+	};
+
+	struct Brightness : Glass::PropertyDefinition<Brightness, Glass::FloatPropertyType> {
+		static constexpr const char* const name = "Brightness";
+		static constexpr float defaultValue = 1.f;
+	};
+
+	//! Dark text on light themes, light text on dark ones
+	struct TextColor
+	    : Glass::ComputedPropertyDefinition<TextColor, ColorPropertyType, Theme, Brightness> {
+		static constexpr const char* const name = "Text Color";
+		static Color compute(int32_t theme, float brightness) {
+			++computeCount;
+			const auto level = theme == 0 ? 1.f - brightness : brightness;
+			return Color{level, level, level};
+		}
+		static inline size_t computeCount = 0;
+	};
+
+	struct TextLevel
+	    : Glass::ComputedPropertyDefinition<TextLevel, Glass::FloatPropertyType, TextColor> {
+		static constexpr const char* const name = "Text Level";
+		static float compute(const Color& color) { return color.r; }
+	};
+
+	using LabelProperties = Glass::PropertyList<Theme, Brightness, TextColor, TextLevel>;
+
+	struct LabelClass : public Glass::HasPropertiesBase,
+	                    public Glass::HasProperties<LabelClass, LabelProperties> {
+		void didSet(Theme) {
+			if (shouldReadTextLevelAtThemeDidSet) {
+				textLevelAtThemeDidSet = GetProperty<TextLevel>();
+			}
+		}
+		void didSet(TextColor) { ++textColorSetCount; }
+
+		size_t textColorSetCount = 0;
+		bool shouldReadTextLevelAtThemeDidSet = false;
+		float textLevelAtThemeDidSet = 0.f;
+	};
+}
+
+static_assert(Glass::Meta::IsComputedProperty<TextColor>);
+static_assert(!Glass::Meta::IsComputedProperty<Theme>);
+
+TEST(HasPropertiesComputed, ComputedOnFirstRead) {
+	LabelClass label;
+	TextColor::computeCount = 0;
+	ASSERT_EQ((Color{0.f, 0.f, 0.f}), label.GetProperty<TextColor>());
+	ASSERT_EQ(1u, TextColor::computeCount);
+	ASSERT_EQ(0.f, label.GetProperty<TextLevel>());
+	ASSERT_EQ(1u, TextColor::computeCount);
+	// The first value equals the default, so nothing was set
+	ASSERT_EQ(0u, label.textColorSetCount);
+}
+
+TEST(HasPropertiesComputed, RecomputedLazilyWhenInputsChange) {
+	LabelClass label;
+	label.GetProperty<TextColor>();
+	TextColor::computeCount = 0;
+
+	label.SetProperty<Theme>(1);
+	label.SetProperty<Brightness>(.25f);
+	ASSERT_EQ(0u, TextColor::computeCount);
+	ASSERT_EQ((Color{.25f, .25f, .25f}), label.GetPropertyRef<TextColor>());
+	ASSERT_EQ(1u, TextColor::computeCount);
+	ASSERT_EQ(1u, label.textColorSetCount);
+	label.GetProperty<TextColor>();
+	ASSERT_EQ(1u, TextColor::computeCount);
+
+	// Computed properties that depend on computed properties see changes to their inputs
+	label.SetProperty<Brightness>(.5f);
+	ASSERT_EQ(.5f, label.GetProperty<TextLevel>());
+	ASSERT_EQ(2u, TextColor::computeCount);
+}
+
+TEST(HasPropertiesComputed, SnapshotsAreUpToDate) {
+	LabelClass label;
+	label.SetProperty<Theme>(1);
+	const auto snapshot = label.Snapshot();
+	ASSERT_EQ(1.f, snapshot.Get<TextLevel>());
+
+	LabelClass other;
+	ASSERT_EQ(std::bitset<4>{"1101"}, label.DiffProperties(other));
+}
+
+TEST(HasPropertiesComputed, HandlersSeeUpToDateValues) {
+	LabelClass label;
+	label.shouldReadTextLevelAtThemeDidSet = true;
+	label.GetProperty<TextLevel>();
+	label.SetProperty<Theme>(1);
+	ASSERT_EQ(1.f, label.textLevelAtThemeDidSet);
+}
+
+TEST(HasPropertiesComputed, PollingRecomputes) {
+	LabelClass label;
+	label.GetProperty<TextLevel>();
+	label.ConsumeDirty();
+	const auto version = label.GetPropertiesVersion();
+
+	label.SetProperty<Brightness>(.5f);
+	ASSERT_EQ(std::bitset<4>{"1110"}, label.GetChangedSince(version));
+	ASSERT_EQ(std::bitset<4>{"1110"}, label.ConsumeDirty());
+}
+
+TEST(HasPropertiesComputed, RestoreRecomputes) {
+	Glass::PropertyUndoHistory history;
+	LabelClass label;
+	label.shouldReadTextLevelAtThemeDidSet = true;
+	label.SetUndoHistory(&history);
+	const auto snapshot = label.Snapshot();
+	label.SetProperty<Theme>(1);
+	label.SetProperty<Brightness>(.25f);
+	ASSERT_EQ(.25f, label.GetProperty<TextLevel>());
+	ASSERT_EQ(2u, history.GetUndoCount());
+
+	label.Restore(snapshot);
+	// Only the inputs are set, and their handlers see the computed properties of the snapshot
+	ASSERT_EQ(4u, history.GetUndoCount());
+	ASSERT_EQ(0.f, label.textLevelAtThemeDidSet);
+	ASSERT_EQ(0.f, label.GetProperty<TextLevel>());
+}
+
+TEST(HasPropertiesComputed, SerializationRoundTrip) {
+	LabelClass label;
+	label.SetProperty<Theme>(1);
+	label.SetProperty<Brightness>(.25f);
+	const auto serialized = Glass::SerializeProperties<LabelProperties>(label);
+	// Computed properties are left out, since they are recomputed from their inputs
+	ASSERT_EQ(2u, serialized.size());
+	ASSERT_EQ(std::string{"Theme"}, serialized[0].name);
+	ASSERT_EQ(std::string{"Brightness"}, serialized[1].name);
+
+	LabelClass other;
+	Glass::DeserializeProperties<LabelProperties>(other, serialized);
+	ASSERT_EQ(label.GetProperty<TextColor>(), other.GetProperty<TextColor>());
+	ASSERT_EQ(.25f, other.GetProperty<TextLevel>());
+
+	// Serialized computed properties are ignored
+	Glass::DeserializeProperties<LabelProperties>(other, {{"Text Level", "0.75"}});
+	ASSERT_EQ(.25f, other.GetProperty<TextLevel>());
+}
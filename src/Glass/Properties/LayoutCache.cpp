@@ -0,0 +1,157 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/LayoutCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+#include "Glass/Properties/Private/GlobalPropertyData.h"
+#include "Glass/Properties/Private/MappedFile.h"
+#include "Glass/Properties/Private/ReplaceFile.h"
+#include "Glass/Properties/SimplePropertyHolder.h"
+#include "Glass/Properties/Types/BinaryCodec.h"
+
+// Layout cache format:
+//   char[4]  magic
+//   uint32_t LayoutCacheVersion
+//   uint64_t layout hash
+//   uint32_t type count, followed by each length prefixed type name
+//   uint32_t holder count, followed by each length prefixed SimplePropertyHolder::SerializeBinary
+
+namespace {
+	using Magic = std::array<char, 4>;
+	constexpr Magic LayoutCacheMagic{{'G', 'L', 'C', 'F'}};
+
+	bool hasBinaryCodec(std::string_view typeName) {
+		return Glass::Private::GlobalPropertyData::getPropertyBinaryCodec(typeName) != nullptr;
+	}
+}
+
+uint64_t Glass::HashLayoutSource(std::string_view layoutSource) {
+	// 64 bit FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (const char c : layoutSource) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool Glass::WriteLayoutCache(const std::string& path,
+                             uint64_t layoutHash,
+                             const vector<const SimplePropertyHolder*>& holders) {
+	BinaryWriter writer;
+	writer.Write(LayoutCacheMagic);
+	writer.Write(LayoutCacheVersion);
+	writer.Write(layoutHash);
+
+	std::set<std::string_view> typeNames;
+	for (const auto* holder : holders) {
+		for (const auto typeName : holder->GetPropertyTypeNames()) {
+			if (hasBinaryCodec(typeName)) {
+				typeNames.insert(typeName);
+			}
+		}
+	}
+	writer.WriteSize(typeNames.size());
+	for (const auto typeName : typeNames) {
+		writer.WriteString(typeName);
+	}
+
+	writer.WriteSize(holders.size());
+	for (const auto* holder : holders) {
+		const auto sizeOffset = writer.GetSize();
+		writer.WriteSize(0);
+		holder->SerializeBinary(writer);
+		writer.PatchSize(sizeOffset, writer.GetSize() - sizeOffset - sizeof(uint32_t));
+	}
+
+	const auto temporaryPath = path + ".tmp";
+	std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+	const auto& buffer = writer.GetBuffer();
+	file.write(reinterpret_cast<const char*>(buffer.data()),
+	           static_cast<std::streamsize>(buffer.size()));
+	// Closing flushes the stream's buffer, which can fail too
+	file.close();
+	if (!file || !Private::syncFile(temporaryPath) ||
+	    !Private::replaceFile(temporaryPath, path)) {
+		std::remove(temporaryPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool Glass::ReadLayoutCache(const std::string& path,
+                            uint64_t layoutHash,
+                            const vector<SimplePropertyHolder*>& holders) {
+	const auto file = Private::MappedFile::Open(path);
+	if (!file) {
+		return false;
+	}
+	BinaryReader reader{file->GetData(), file->GetSize()};
+
+	const auto magic = reader.Read<Magic>();
+	const auto version = reader.Read<uint32_t>();
+	const auto hash = reader.Read<uint64_t>();
+	if (!magic || *magic != LayoutCacheMagic || !version || *version != LayoutCacheVersion ||
+	    !hash || *hash != layoutHash) {
+		return false;
+	}
+
+	const auto typeCount = reader.ReadSize();
+	if (!typeCount) {
+		return false;
+	}
+	for (size_t i = 0; i < *typeCount; ++i) {
+		const auto typeName = reader.ReadStringView();
+		if (!typeName || !hasBinaryCodec(*typeName)) {
+			return false;
+		}
+	}
+
+	const auto holderCount = reader.ReadSize();
+	if (!holderCount || *holderCount != holders.size()) {
+		return false;
+	}
+	// Split the data for every holder up front so that a truncated cache is rejected before any
+	// holder is modified.
+	vector<BinaryReader> holderReaders;
+	holderReaders.reserve(holders.size());
+	for (size_t i = 0; i < holders.size(); ++i) {
+		const auto size = reader.ReadSize();
+		if (!size) {
+			return false;
+		}
+		auto holderReader = reader.ReadSubReader(*size);
+		if (!holderReader) {
+			return false;
+		}
+		holderReaders.push_back(*holderReader);
+	}
+	if (!reader.IsAtEnd()) {
+		return false;
+	}
+
+	for (size_t i = 0; i < holders.size(); ++i) {
+		if (!holders[i]->DeserializeBinary(holderReaders[i]) || !holderReaders[i].IsAtEnd()) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,62 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Glass {
+	class SimplePropertyHolder;
+
+	//! Precompiled layout caches
+	//!
+	//! Deserializing a layout from text parses every property of every widget.  Once a layout has
+	//! been loaded, the deserialized state of its property holders can be written to a layout
+	//! cache with WriteLayoutCache.  On later launches, ReadLayoutCache memory maps the cache and
+	//! initializes the holders with the binary codecs (see PropertyType), which copy trivially
+	//! copyable values straight out of the mapping.
+	//!
+	//! A cache is keyed by a hash of the layout source it was built from, and records the names
+	//! of the property types it contains.  A cache built from a different layout, by a different
+	//! cache version, or containing a type that is no longer registered with a binary codec is
+	//! rejected, and callers should fall back to deserializing the layout text.
+	//!
+	//! Holders are identified by their position, so the same layout must produce the same
+	//! holders in the same order when reading as it did when writing.
+
+	//! Version of the layout cache file format.  Bump this when the format, or the binary
+	//! encoding of any builtin type, changes.
+	constexpr uint32_t LayoutCacheVersion = 1;
+
+	//! Hash of a layout's source, used to key the cache.
+	uint64_t HashLayoutSource(std::string_view layoutSource);
+
+	//! Write the current property values of `holders` to the cache at `path`.  The new cache is
+	//! synced to disk, then replaces the old one atomically, so that neither a concurrent launch
+	//! nor a launch after a power loss reads a partially written cache.  Returns false if the
+	//! file couldn't be written, synced or replaced, in which case the old cache is kept.
+	bool WriteLayoutCache(const std::string& path,
+	                      uint64_t layoutHash,
+	                      const vector<const SimplePropertyHolder*>& holders);
+
+	//! Initialize `holders` from the cache at `path`.  Returns false without touching any
+	//! holder if the cache is missing, stale, or references unregistered types.  Returns false
+	//! after modifying holders only if the cache is corrupt.
+	bool ReadLayoutCache(const std::string& path,
+	                     uint64_t layoutHash,
+	                     const vector<SimplePropertyHolder*>& holders);
+}
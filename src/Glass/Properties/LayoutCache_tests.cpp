@@ -0,0 +1,115 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "Glass/Properties/LayoutCache.h"
+#include "Glass/Properties/SimplePropertyHolder.h"
+#include "Glass/Properties/Types/BinaryCodec.h"
+#include "Glass/Properties/Types/Builtins.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+namespace {
+	using Glass::SimplePropertyHolder;
+
+	const std::string LayoutSource = "<View IntValue=\"42\" Title=\"hello\"/>";
+
+	class LayoutCacheTests : public ::testing::Test {
+	public:
+		void SetUp() override {
+			source.CreateProperty("IntValue", "Int", 42);
+			source.CreateProperty("Title", "std::string", std::string{"hello"});
+			destination.CreateProperty("IntValue", "Int", 0);
+			destination.CreateProperty("Title", "std::string", std::string{});
+		}
+
+		void TearDown() override { std::remove(path.c_str()); }
+
+		void writeRawFile(const vector<uint8_t>& bytes) {
+			std::ofstream file{path, std::ios::binary | std::ios::trunc};
+			file.write(reinterpret_cast<const char*>(bytes.data()),
+			           static_cast<std::streamsize>(bytes.size()));
+		}
+
+		const std::string path = ::testing::TempDir() + "LayoutCacheTests.cache";
+		const uint64_t layoutHash = Glass::HashLayoutSource(LayoutSource);
+		SimplePropertyHolder source;
+		SimplePropertyHolder destination;
+	};
+
+	TEST_F(LayoutCacheTests, HashDependsOnSource) {
+		ASSERT_EQ(layoutHash, Glass::HashLayoutSource(LayoutSource));
+		ASSERT_NE(layoutHash, Glass::HashLayoutSource(LayoutSource + " "));
+	}
+
+	TEST_F(LayoutCacheTests, RoundTrip) {
+		ASSERT_TRUE(Glass::WriteLayoutCache(path, layoutHash, {&source}));
+		ASSERT_TRUE(Glass::ReadLayoutCache(path, layoutHash, {&destination}));
+		ASSERT_EQ(42, *destination.GetProperty<int>("IntValue"));
+		ASSERT_EQ(std::string{"hello"}, *destination.GetProperty<std::string>("Title"));
+	}
+
+	TEST_F(LayoutCacheTests, MissingCache) {
+		ASSERT_FALSE(Glass::ReadLayoutCache(path, layoutHash, {&destination}));
+	}
+
+	TEST_F(LayoutCacheTests, StaleLayoutIsRejected) {
+		ASSERT_TRUE(Glass::WriteLayoutCache(path, layoutHash, {&source}));
+		ASSERT_FALSE(Glass::ReadLayoutCache(
+		    path, Glass::HashLayoutSource(LayoutSource + " "), {&destination}));
+		ASSERT_EQ(0, *destination.GetProperty<int>("IntValue"));
+	}
+
+	TEST_F(LayoutCacheTests, HolderCountMismatchIsRejected) {
+		ASSERT_TRUE(Glass::WriteLayoutCache(path, layoutHash, {&source, &source}));
+		ASSERT_FALSE(Glass::ReadLayoutCache(path, layoutHash, {&destination}));
+		ASSERT_EQ(0, *destination.GetProperty<int>("IntValue"));
+	}
+
+	TEST_F(LayoutCacheTests, UnregisteredTypeIsRejected) {
+		Glass::BinaryWriter writer;
+		writer.Write(std::array<char, 4>{{'G', 'L', 'C', 'F'}});
+		writer.Write(Glass::LayoutCacheVersion);
+		writer.Write(layoutHash);
+		writer.WriteSize(1);
+		writer.WriteString("Not a registered type");
+		writer.WriteSize(1);
+		writer.WriteSize(sizeof(uint32_t));
+		writer.WriteSize(0);
+		writeRawFile(writer.GetBuffer());
+
+		ASSERT_FALSE(Glass::ReadLayoutCache(path, layoutHash, {&destination}));
+	}
+
+	TEST_F(LayoutCacheTests, TruncatedCacheIsRejected) {
+		ASSERT_TRUE(Glass::WriteLayoutCache(path, layoutHash, {&source}));
+		vector<uint8_t> bytes;
+		{
+			std::ifstream file{path, std::ios::binary};
+			bytes.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+		}
+		bytes.pop_back();
+		writeRawFile(bytes);
+
+		ASSERT_FALSE(Glass::ReadLayoutCache(path, layoutHash, {&destination}));
+		ASSERT_EQ(0, *destination.GetProperty<int>("IntValue"));
+	}
+}
@@ -57,15 +57,22 @@
 //! <PropType> The type of the property (derived from Glass::PropertyType)
 //!
 //! <DefaultValue> The property's default value
+//!
+//! Besides the PropertyDefinitions, the namespace gets `List`, the PropertyList of all of them,
+//! and `Index`, the PropertyListIndex of `List`.  Property names within one use of this macro
+//! must be distinct.
 #define GLASS_PROPERTIES(NameSpace, ...)                                                           \
 	namespace NameSpace {                                                                          \
 		GLASS_PS(BOOST_PP_VARIADIC_TO_LIST(__VA_ARGS__))                                           \
 		using List = GLASS_PL(__VA_ARGS__);                                                        \
+		using Index = ::Glass::PropertyListIndex<List>;                                            \
+		static_assert(Index::HashIndex.isValid);                                                   \
 	}
 
 //! When inheriting from multiple HasProperties types, it is necessary to using GetProperty and
 //! SetProperty to bring them into the derived classes overload set.  This macro takes a typename as
-//! a paremeter and expands to `using T::GetProperty; using T::SetProperty`.
+//! a paremeter and expands to `using T::GetProperty; using T::SetProperty`, along with the other
+//! property accessors of HasProperties.
 //!
 //! Accepts a list of base types to generate using statements for.  Each base type listed must be
 //! enclosed in parenthesis so that the macro can work with multi-parameter templated types.
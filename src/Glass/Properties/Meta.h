@@ -37,6 +37,12 @@ namespace Glass {
 		    HasSetNeedsDisplay<T, std::void_t<decltype(std::declval<T>().SetNeedsDisplay())>> =
 		        true;
 
+		template <typename D, typename = void> constexpr inline bool IsComputedProperty = false;
+
+		//! Whether D is a ComputedPropertyDefinition
+		template <typename D>
+		constexpr inline bool IsComputedProperty<D, std::void_t<typename D::inputs>> = true;
+
 		template <typename D>
 		constexpr inline bool IsLayoutProperty = std::is_base_of<LayoutProperty, D>::value;
 
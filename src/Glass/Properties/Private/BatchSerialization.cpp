@@ -0,0 +1,187 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/Private/BatchSerialization.h"
+
+#include <unordered_map>
+
+#include "Glass/Properties/Private/DeserializationCache.h"
+#include "Glass/Properties/Private/ThreadPool.h"
+
+namespace {
+	using Glass::Private::GlobalPropertyData::ContextDeserializationCache;
+	using Glass::Private::GlobalPropertyData::PropertyDeserializationInput;
+	using Glass::Private::GlobalPropertyData::PropertyDeserializationResult;
+	using Glass::Private::GlobalPropertyData::PropertyTypeRegistration;
+
+	//! Batches smaller than this aren't worth handing to the thread pool
+	constexpr size_t MinParallelBatchSize = 64;
+	//! Largest run of values given to a type's batch deserializer at once.  Runs are spread
+	//! across the thread pool, so they shouldn't be too long either.
+	constexpr size_t MaxBatchDeserializerRun = 256;
+
+	//! Inputs of one type to give to its batch deserializer together
+	struct BatchDeserializerRun {
+		const PropertyTypeRegistration* type;
+		vector<size_t> inputs;
+	};
+
+	//! Look up the registration of each distinct type in the batch once, up front.  The
+	//! workers then call the registration's typed serialize and deserializeInto directly,
+	//! without building the type erased serialization data.  Returns the registration of each
+	//! input, or nullptr if its type isn't registered.
+	template <typename Input>
+	vector<const PropertyTypeRegistration*> getBatchPropertyTypes(const vector<Input>& inputs) {
+		std::unordered_map<std::string_view, const PropertyTypeRegistration*> types;
+		vector<const PropertyTypeRegistration*> inputTypes;
+		inputTypes.reserve(inputs.size());
+		for (const auto& input : inputs) {
+			auto it = types.find(input.typeName);
+			if (it == types.end()) {
+				it = types
+				         .emplace(input.typeName,
+				                  Glass::Private::GlobalPropertyData::findPropertyTypeRegistration(
+				                      input.typeName))
+				         .first;
+			}
+			inputTypes.push_back(it->second);
+		}
+		return inputTypes;
+	}
+
+	//! Call `fn(i)` for every i in [0, count), on the shared thread pool if `workSize` values
+	//! are enough to be worth it
+	void parallelFor(size_t count, size_t workSize, const std::function<void(size_t)>& fn) {
+		if (workSize < MinParallelBatchSize) {
+			for (size_t i = 0; i < count; ++i) {
+				fn(i);
+			}
+			return;
+		}
+		Glass::Private::WorkStealingThreadPool::GetShared().ParallelFor(count, fn);
+	}
+
+	//! Deserialize `inputs` against `context`, or against the context of `cache` through the
+	//! cache if there is one
+	vector<std::optional<PropertyDeserializationResult>>
+	deserializeInputs(const vector<PropertyDeserializationInput>& inputs,
+	                  const boost::any& context,
+	                  ContextDeserializationCache* cache) {
+		const auto inputTypes = getBatchPropertyTypes(inputs);
+
+		vector<std::optional<PropertyDeserializationResult>> results(inputs.size());
+		auto deserialize = [&](size_t i) {
+			PropertyDeserializationResult deserialized;
+			if (inputTypes[i]->deserializeInto(std::string{inputs[i].serializedValue},
+			                                   context,
+			                                   deserialized.value,
+			                                   deserialized.scratchSpace)) {
+				results[i] = std::move(deserialized);
+			}
+		};
+
+		// Types with a batch deserializer get runs of their inputs, and the rest are
+		// deserialized one at a time
+		vector<BatchDeserializerRun> runs;
+		size_t runInputCount = 0;
+		std::unordered_map<const PropertyTypeRegistration*, size_t> currentRuns;
+		vector<size_t> parallelInputs;
+		vector<size_t> contextInputs;
+		parallelInputs.reserve(inputs.size());
+		for (size_t i = 0; i < inputs.size(); ++i) {
+			const auto* type = inputTypes[i];
+			if (!type) {
+				continue;
+			}
+			if (type->hasDeserializationContext) {
+				contextInputs.push_back(i);
+			} else if (type->deserializeBatch) {
+				auto [it, isNewType] = currentRuns.emplace(type, runs.size());
+				if (isNewType || runs[it->second].inputs.size() == MaxBatchDeserializerRun) {
+					it->second = runs.size();
+					runs.push_back(BatchDeserializerRun{type, {}});
+				}
+				runs[it->second].inputs.push_back(i);
+				++runInputCount;
+			} else {
+				parallelInputs.push_back(i);
+			}
+		}
+
+		parallelFor(runs.size(), runInputCount, [&](size_t i) {
+			const auto& run = runs[i];
+			vector<std::string_view> serializedValues;
+			serializedValues.reserve(run.inputs.size());
+			for (const auto input : run.inputs) {
+				serializedValues.push_back(inputs[input].serializedValue);
+			}
+			vector<std::optional<boost::any>> values(run.inputs.size());
+			run.type->deserializeBatch(serializedValues, values);
+			for (size_t j = 0; j < run.inputs.size(); ++j) {
+				if (values[j]) {
+					results[run.inputs[j]] =
+					    PropertyDeserializationResult{{}, std::move(*values[j])};
+				}
+			}
+		});
+		parallelFor(parallelInputs.size(), parallelInputs.size(), [&](size_t i) {
+			deserialize(parallelInputs[i]);
+		});
+		for (const auto i : contextInputs) {
+			if (cache) {
+				results[i] = cache->Deserialize(inputs[i].typeName,
+				                                std::string{inputs[i].serializedValue});
+			} else {
+				deserialize(i);
+			}
+		}
+		return results;
+	}
+}
+
+vector<std::optional<std::string>> Glass::Private::GlobalPropertyData::serializeBatch(
+    const vector<PropertySerializationInput>& inputs) {
+	const auto inputTypes = getBatchPropertyTypes(inputs);
+
+	vector<std::optional<std::string>> results(inputs.size());
+	const boost::any noScratchSpace;
+	parallelFor(inputs.size(), inputs.size(), [&](size_t i) {
+		const auto& input = inputs[i];
+		const auto* type = inputTypes[i];
+		if (!type || !input.value) {
+			return;
+		}
+		const auto& scratchSpace = input.scratchSpace ? *input.scratchSpace : noScratchSpace;
+		auto serialized = type->serialize(*input.value, scratchSpace);
+		if (serialized) {
+			results[i] = std::move(*serialized);
+		}
+	});
+	return results;
+}
+
+vector<std::optional<Glass::Private::GlobalPropertyData::PropertyDeserializationResult>>
+Glass::Private::GlobalPropertyData::deserializeBatch(
+    const vector<PropertyDeserializationInput>& inputs, const boost::any& context) {
+	return deserializeInputs(inputs, context, nullptr);
+}
+
+vector<std::optional<Glass::Private::GlobalPropertyData::PropertyDeserializationResult>>
+Glass::Private::GlobalPropertyData::deserializeBatch(
+    const vector<PropertyDeserializationInput>& inputs, ContextDeserializationCache& cache) {
+	return deserializeInputs(inputs, cache.GetContext(), &cache);
+}
@@ -0,0 +1,69 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Glass/Properties/Private/GlobalPropertyData.h"
+
+namespace Glass {
+	namespace Private {
+		namespace GlobalPropertyData {
+			class ContextDeserializationCache;
+
+			//! A property value to serialize with serializeBatch
+			struct PropertySerializationInput {
+				std::string_view typeName;
+				const boost::any* value = nullptr;
+				//! nullptr if the property has no scratch space
+				const boost::any* scratchSpace = nullptr;
+			};
+
+			//! A serialized property value to deserialize with deserializeBatch
+			struct PropertyDeserializationInput {
+				std::string_view typeName;
+				std::string_view serializedValue;
+			};
+
+			//! Serialize every input with the serializer of its globally registered type,
+			//! spreading the work across WorkStealingThreadPool::GetShared().  Each result is
+			//! at the index of its input, and is std::nullopt if the type isn't registered or
+			//! the value failed to serialize.
+			vector<std::optional<std::string>>
+			serializeBatch(const vector<PropertySerializationInput>& inputs);
+
+			//! Deserialize every input with the deserializer of its globally registered type.
+			//! Each result is at the index of its input, and is std::nullopt if the type isn't
+			//! registered or the value failed to deserialize.
+			//!
+			//! Types that read the deserialization context are deserialized one at a time on
+			//! the calling thread, since contexts aren't required to be thread safe.  The rest
+			//! are spread across WorkStealingThreadPool::GetShared().  The inputs of types with
+			//! a batch deserializer (see PropertyType) are given to it in runs.
+			vector<std::optional<PropertyDeserializationResult>>
+			deserializeBatch(const vector<PropertyDeserializationInput>& inputs,
+			                 const boost::any& context = {});
+
+			//! Same as above, but types that read the deserialization context are deserialized
+			//! against the context of `cache`, through the cache.
+			vector<std::optional<PropertyDeserializationResult>>
+			deserializeBatch(const vector<PropertyDeserializationInput>& inputs,
+			                 ContextDeserializationCache& cache);
+		}
+	}
+}
@@ -0,0 +1,153 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include <mutex>
+#include <thread>
+
+#include "Glass/Properties/Private/BatchSerialization.h"
+#include "Glass/Properties/Types/Builtins.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+using namespace Glass::Private::GlobalPropertyData;
+
+namespace {
+	std::mutex g_contextThreadsMutex;
+	vector<std::thread::id> g_contextThreads;
+
+	struct BatchContextPropertyType : Glass::PropertyType<int32_t> {
+		static constexpr auto name = "BatchContext";
+		using context_type = int32_t;
+		static std::optional<std::string> serialize(int32_t value) {
+			return std::to_string(value);
+		}
+		static std::optional<int32_t> deserialize(const std::string& value,
+		                                          const int32_t* offset) {
+			{
+				std::lock_guard<std::mutex> lock{g_contextThreadsMutex};
+				g_contextThreads.push_back(std::this_thread::get_id());
+			}
+			if (!offset) {
+				return std::nullopt;
+			}
+			return std::stoi(value) + *offset;
+		}
+	};
+
+	constexpr size_t BatchSize = 1000;
+}
+
+TEST(BatchSerialization, SerializeKeepsInputOrder) {
+	vector<boost::any> values;
+	for (size_t i = 0; i < BatchSize; ++i) {
+		values.emplace_back(static_cast<int32_t>(i));
+	}
+	vector<PropertySerializationInput> inputs;
+	for (const auto& value : values) {
+		inputs.push_back({Glass::IntPropertyType::name, &value});
+	}
+	inputs.push_back({"Not a registered type", &values.front()});
+
+	const auto results = serializeBatch(inputs);
+	ASSERT_EQ(inputs.size(), results.size());
+	for (size_t i = 0; i < BatchSize; ++i) {
+		ASSERT_TRUE(results[i]);
+		ASSERT_EQ(Glass::IntPropertyType::serialize(static_cast<int32_t>(i)), *results[i]);
+	}
+	ASSERT_FALSE(results.back());
+}
+
+TEST(BatchSerialization, DeserializeKeepsInputOrder) {
+	vector<std::string> serializedValues;
+	for (size_t i = 0; i < BatchSize; ++i) {
+		serializedValues.push_back(std::to_string(i));
+	}
+	vector<PropertyDeserializationInput> inputs;
+	for (const auto& serializedValue : serializedValues) {
+		inputs.push_back({Glass::IntPropertyType::name, serializedValue});
+	}
+	inputs.push_back({"Not a registered type", "1"});
+	inputs.push_back({Glass::IntPropertyType::name, "not an int"});
+
+	const auto results = deserializeBatch(inputs);
+	ASSERT_EQ(inputs.size(), results.size());
+	for (size_t i = 0; i < BatchSize; ++i) {
+		ASSERT_TRUE(results[i]);
+		const auto* value = boost::any_cast<int32_t>(&results[i]->value);
+		ASSERT_TRUE(value);
+		ASSERT_EQ(static_cast<int32_t>(i), *value);
+	}
+	ASSERT_FALSE(results[BatchSize]);
+	ASSERT_FALSE(results[BatchSize + 1]);
+}
+
+TEST(BatchSerialization, BatchDeserializers) {
+	vector<std::string> serializedValues;
+	for (size_t i = 0; i < BatchSize; ++i) {
+		serializedValues.push_back(std::to_string(i) + (i % 3 ? ".5" : "f"));
+	}
+	vector<PropertyDeserializationInput> inputs;
+	for (const auto& serializedValue : serializedValues) {
+		inputs.push_back({Glass::FloatPropertyType::name, serializedValue});
+		inputs.push_back({Glass::StringPropertyType::name, serializedValue});
+	}
+
+	const auto results = deserializeBatch(inputs);
+	for (size_t i = 0; i < BatchSize; ++i) {
+		const auto expected = Glass::FloatPropertyType::deserialize(serializedValues[i]);
+		ASSERT_TRUE(expected);
+		ASSERT_TRUE(results[2 * i]);
+		ASSERT_EQ(*expected, boost::any_cast<float>(results[2 * i]->value));
+		ASSERT_TRUE(results[2 * i + 1]);
+		ASSERT_EQ(serializedValues[i], boost::any_cast<std::string>(results[2 * i + 1]->value));
+	}
+}
+
+TEST(BatchSerialization, TypedBatchDeserializer) {
+	// BoolPropertyType has no batch deserializer, so this falls back to its scalar one
+	const vector<std::string_view> serializedValues{"true", "false", "nope"};
+	vector<std::optional<bool>> values(serializedValues.size());
+	DeserializeBatch<Glass::BoolPropertyType>(serializedValues, values);
+	for (size_t i = 0; i < serializedValues.size(); ++i) {
+		const auto expected =
+		    Glass::BoolPropertyType::deserialize(std::string{serializedValues[i]});
+		ASSERT_EQ(expected, values[i]);
+	}
+}
+
+TEST(BatchSerialization, ContextTypesRunOnCallingThread) {
+	AddPropertyTypeData<BatchContextPropertyType>();
+	g_contextThreads.clear();
+
+	vector<PropertyDeserializationInput> inputs;
+	for (size_t i = 0; i < BatchSize; ++i) {
+		inputs.push_back({i % 2 ? BatchContextPropertyType::name : Glass::IntPropertyType::name,
+		                  "5"});
+	}
+	const auto results = deserializeBatch(inputs, boost::any{int32_t{10}});
+	for (size_t i = 0; i < BatchSize; ++i) {
+		ASSERT_TRUE(results[i]);
+		ASSERT_EQ(i % 2 ? 15 : 5, boost::any_cast<int32_t>(results[i]->value));
+	}
+
+	ASSERT_EQ(BatchSize / 2, g_contextThreads.size());
+	for (const auto& thread : g_contextThreads) {
+		ASSERT_EQ(std::this_thread::get_id(), thread);
+	}
+}
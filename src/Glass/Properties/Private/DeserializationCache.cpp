@@ -0,0 +1,80 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/Private/DeserializationCache.h"
+
+using Glass::Private::GlobalPropertyData::ContextDeserializationCache;
+using Glass::Private::GlobalPropertyData::PropertyDeserializationResult;
+
+ContextDeserializationCache::ContextDeserializationCache(boost::any context)
+    : m_context{std::move(context)} {}
+
+void ContextDeserializationCache::SetContext(boost::any context) {
+	m_context = std::move(context);
+	Invalidate();
+}
+
+void ContextDeserializationCache::Invalidate() {
+	// The serialization data of each type doesn't depend on the context, so keep it
+	for (auto& type : m_types) {
+		type.second.results.clear();
+	}
+}
+
+std::optional<PropertyDeserializationResult>
+ContextDeserializationCache::Deserialize(std::string_view typeName,
+                                         const std::string& serializedValue) {
+	const auto* registration = findPropertyTypeRegistration(typeName);
+	if (!registration) {
+		return std::nullopt;
+	}
+	auto typeIt = m_types.find(registration);
+	if (typeIt == m_types.end()) {
+		typeIt = m_types
+		             .emplace(registration,
+		                      CachedType{(registration->serializationData)(),
+		                                 registration->hasDeserializationContext,
+		                                 {}})
+		             .first;
+	}
+	auto& type = typeIt->second;
+
+	auto deserialize = [&]() -> std::optional<PropertyDeserializationResult> {
+		auto deserialized = type.serializationData.deserialize(serializedValue, m_context);
+		if (!deserialized) {
+			return std::nullopt;
+		}
+		return PropertyDeserializationResult{std::move(deserialized->scratchSpace),
+		                                     std::move(deserialized->value)};
+	};
+	if (!type.hasDeserializationContext) {
+		return deserialize();
+	}
+	if (const auto it = type.results.find(serializedValue); it != type.results.end()) {
+		return it->second;
+	}
+	return type.results.emplace(serializedValue, deserialize()).first->second;
+}
+
+size_t ContextDeserializationCache::GetSize() const {
+	size_t size = 0;
+	for (const auto& type : m_types) {
+		size += type.second.results.size();
+	}
+	return size;
+}
@@ -0,0 +1,74 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Glass/Properties/Private/GlobalPropertyData.h"
+
+namespace Glass {
+	namespace Private {
+		namespace GlobalPropertyData {
+			//! Memoizes deserialization against a single deserialization context.
+			//!
+			//! Types with a `context_type`, like keypaths resolved against the KVC, look their
+			//! value up in the context on every deserialize, while a layout deserializes the
+			//! same few strings for many widgets.  This keeps the result of each (type,
+			//! serialized value) pair, including failures, so only the first of them reaches
+			//! the type's deserializer.  Types without a context are deserialized directly.
+			//!
+			//! Setting a new context clears the cached results.  Call Invalidate after changing
+			//! the context in place.  Not thread safe.
+			class ContextDeserializationCache {
+			public:
+				ContextDeserializationCache() = default;
+				explicit ContextDeserializationCache(boost::any context);
+
+				//! Deserialize against this cache's context from now on
+				void SetContext(boost::any context);
+				const boost::any& GetContext() const { return m_context; }
+
+				//! Forget every cached result
+				void Invalidate();
+
+				//! Deserialize `serializedValue` with the globally registered type `typeName`.
+				//! Returns std::nullopt if the type isn't registered or the value failed to
+				//! deserialize.
+				std::optional<PropertyDeserializationResult>
+				Deserialize(std::string_view typeName, const std::string& serializedValue);
+
+				//! Number of cached results, for all types
+				size_t GetSize() const;
+
+			private:
+				struct CachedType {
+					PropertyTypeSerializationData serializationData;
+					bool hasDeserializationContext;
+					std::unordered_map<std::string, std::optional<PropertyDeserializationResult>>
+					    results;
+				};
+
+				boost::any m_context;
+				//! Registrations are never removed, so their addresses identify the types
+				std::unordered_map<const PropertyTypeRegistration*, CachedType> m_types;
+			};
+		}
+	}
+}
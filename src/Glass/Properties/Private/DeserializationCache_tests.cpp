@@ -0,0 +1,138 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include <map>
+
+#include "Glass/Properties/Private/BatchSerialization.h"
+#include "Glass/Properties/Private/DeserializationCache.h"
+#include "Glass/Properties/Types/Builtins.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+using namespace Glass::Private::GlobalPropertyData;
+
+namespace {
+	using KeyPaths = std::map<std::string, int32_t>;
+	//! Like the KVC, the context refers to data that can change without the context changing
+	using KeyPathContext = const KeyPaths*;
+
+	size_t g_keyPathLookups = 0;
+
+	//! Resolves the serialized value as a key in the context, like a keypath in the KVC
+	struct CachedKeyPathPropertyType : Glass::PropertyType<int32_t> {
+		static constexpr auto name = "CachedKeyPath";
+		using context_type = KeyPathContext;
+		static std::optional<std::string> serialize(int32_t) { return std::nullopt; }
+		static std::optional<int32_t> deserialize(const std::string& keyPath,
+		                                          const KeyPathContext* context) {
+			++g_keyPathLookups;
+			if (!context || !*context) {
+				return std::nullopt;
+			}
+			const auto it = (*context)->find(keyPath);
+			if (it == (*context)->end()) {
+				return std::nullopt;
+			}
+			return it->second;
+		}
+	};
+
+	struct ContextDeserializationCacheTest : ::testing::Test {
+		void SetUp() override {
+			AddPropertyTypeData<CachedKeyPathPropertyType>();
+			g_keyPathLookups = 0;
+		}
+	};
+}
+
+TEST_F(ContextDeserializationCacheTest, RepeatedValuesAreResolvedOnce) {
+	const KeyPaths keyPaths{{"gain", 3}, {"mix", 7}};
+	ContextDeserializationCache cache{KeyPathContext{&keyPaths}};
+	for (size_t i = 0; i < 100; ++i) {
+		const auto gain = cache.Deserialize(CachedKeyPathPropertyType::name, "gain");
+		ASSERT_TRUE(gain);
+		ASSERT_EQ(3, boost::any_cast<int32_t>(gain->value));
+		const auto mix = cache.Deserialize(CachedKeyPathPropertyType::name, "mix");
+		ASSERT_TRUE(mix);
+		ASSERT_EQ(7, boost::any_cast<int32_t>(mix->value));
+	}
+	ASSERT_EQ(2u, g_keyPathLookups);
+	ASSERT_EQ(2u, cache.GetSize());
+}
+
+TEST_F(ContextDeserializationCacheTest, FailuresAreCached) {
+	const KeyPaths keyPaths;
+	ContextDeserializationCache cache{KeyPathContext{&keyPaths}};
+	ASSERT_FALSE(cache.Deserialize(CachedKeyPathPropertyType::name, "missing"));
+	ASSERT_FALSE(cache.Deserialize(CachedKeyPathPropertyType::name, "missing"));
+	ASSERT_EQ(1u, g_keyPathLookups);
+}
+
+TEST_F(ContextDeserializationCacheTest, NewContextInvalidates) {
+	const KeyPaths keyPaths{{"gain", 3}};
+	ContextDeserializationCache cache{KeyPathContext{&keyPaths}};
+	ASSERT_EQ(3, boost::any_cast<int32_t>(
+	                 cache.Deserialize(CachedKeyPathPropertyType::name, "gain")->value));
+
+	const KeyPaths otherKeyPaths{{"gain", 5}};
+	cache.SetContext(KeyPathContext{&otherKeyPaths});
+	ASSERT_EQ(0u, cache.GetSize());
+	ASSERT_EQ(5, boost::any_cast<int32_t>(
+	                 cache.Deserialize(CachedKeyPathPropertyType::name, "gain")->value));
+	ASSERT_EQ(2u, g_keyPathLookups);
+}
+
+TEST_F(ContextDeserializationCacheTest, InvalidateAfterChangingContextInPlace) {
+	KeyPaths keyPaths;
+	ContextDeserializationCache cache{KeyPathContext{&keyPaths}};
+	ASSERT_FALSE(cache.Deserialize(CachedKeyPathPropertyType::name, "gain"));
+
+	keyPaths["gain"] = 3;
+	ASSERT_FALSE(cache.Deserialize(CachedKeyPathPropertyType::name, "gain"));
+	cache.Invalidate();
+	const auto gain = cache.Deserialize(CachedKeyPathPropertyType::name, "gain");
+	ASSERT_TRUE(gain);
+	ASSERT_EQ(3, boost::any_cast<int32_t>(gain->value));
+}
+
+TEST_F(ContextDeserializationCacheTest, TypesWithoutContextArentCached) {
+	ContextDeserializationCache cache;
+	const auto value = cache.Deserialize(Glass::IntPropertyType::name, "54");
+	ASSERT_TRUE(value);
+	ASSERT_EQ(54, boost::any_cast<int32_t>(value->value));
+	ASSERT_EQ(0u, cache.GetSize());
+	ASSERT_FALSE(cache.Deserialize("NotARegisteredType", "54"));
+}
+
+TEST_F(ContextDeserializationCacheTest, Batch) {
+	const KeyPaths keyPaths{{"gain", 3}, {"mix", 7}};
+	ContextDeserializationCache cache{KeyPathContext{&keyPaths}};
+	vector<PropertyDeserializationInput> inputs;
+	for (size_t i = 0; i < 500; ++i) {
+		inputs.push_back({CachedKeyPathPropertyType::name, i % 2 ? "gain" : "mix"});
+		inputs.push_back({Glass::IntPropertyType::name, "54"});
+	}
+	const auto results = deserializeBatch(inputs, cache);
+	for (size_t i = 0; i < inputs.size(); ++i) {
+		ASSERT_TRUE(results[i]);
+		ASSERT_EQ(i % 2 ? 54 : (i % 4 ? 3 : 7), boost::any_cast<int32_t>(results[i]->value));
+	}
+	ASSERT_EQ(2u, g_keyPathLookups);
+}
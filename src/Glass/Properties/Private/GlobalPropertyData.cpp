@@ -16,12 +16,219 @@
 #include "iZBase/common/common.h"
 
 #include "Glass/Properties/Private/GlobalPropertyData.h"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "Glass/Properties/Private/PerfectHash.h"
+#include "Glass/Properties/Types/OptionalProperty.h"
 #include "iZBase/Util/PropertySerializer.h"
 
-Glass::Private::GlobalPropertyData::PropertySerializationMap&
-Glass::Private::GlobalPropertyData::getPropertySerializationMap() {
-	static PropertySerializationMap map{20};
-	return map;
+namespace {
+	using Glass::Private::GlobalPropertyData::PropertyTypeRegistration;
+
+	//! Immutable copy of the global property data, see freezePropertyTypeRegistry
+	struct FrozenPropertyTypeRegistry {
+		struct Entry {
+			//! Views the key of the same type in PropertyTypeRegistry::map, which is never
+			//! erased
+			std::string_view name;
+			PropertyTypeRegistration registration;
+		};
+
+		const PropertyTypeRegistration* find(std::string_view name) const {
+			if (entries.empty()) {
+				return nullptr;
+			}
+			const auto& entry = entries[index.GetSlot(name)];
+			return entry.name == name ? &entry.registration : nullptr;
+		}
+
+		Glass::Private::PerfectHashIndex index;
+		//! Indexed by slot in `index`
+		vector<Entry> entries;
+	};
+
+	//! The global property data.  Everything but `frozen` is guarded by `mutex`.
+	struct PropertyTypeRegistry {
+		std::mutex mutex;
+		std::unordered_map<std::string, PropertyTypeRegistration> map{20};
+		//! Incremented whenever a type is added to `map`
+		uint64_t generation = 0;
+		//! Number of types in `map` whose Optional variant hasn't been added to it yet
+		size_t unmaterializedOptionalCount = 0;
+		//! Every table that has been frozen.  Earlier tables are kept alive since callers may
+		//! still hold pointers into them.
+		vector<unique_ptr<const FrozenPropertyTypeRegistry>> frozenRegistries;
+		//! The latest of `frozenRegistries`, which is read without the lock
+		std::atomic<const FrozenPropertyTypeRegistry*> frozen{nullptr};
+	};
+
+	PropertyTypeRegistry& getPropertyTypeRegistry() {
+		static PropertyTypeRegistry registry;
+		return registry;
+	}
+
+	//! Find `typeName` in the map, building its Optional variant if needed.  The registry's mutex
+	//! must be held.
+	const PropertyTypeRegistration* findLocked(PropertyTypeRegistry& registry,
+	                                           std::string_view typeName) {
+		if (const auto it = registry.map.find(std::string{typeName}); it != registry.map.end()) {
+			return &it->second;
+		}
+
+		const std::string_view prefix = Glass::Private::OptionalPropertyNamePrefix;
+		if (typeName.substr(0, prefix.size()) != prefix) {
+			return nullptr;
+		}
+		const auto* underlying = findLocked(registry, typeName.substr(prefix.size()));
+		if (!underlying || !underlying->optionalRegistration) {
+			return nullptr;
+		}
+		// unordered_map never moves its elements, so `underlying` stays valid across the insert
+		++registry.generation;
+		if (registry.unmaterializedOptionalCount > 0) {
+			--registry.unmaterializedOptionalCount;
+		}
+		return &registry.map.emplace(std::string{typeName}, underlying->optionalRegistration())
+		            .first->second;
+	}
+
+	//! Add the Optional variant of every type that has one to the map.  The registry's mutex
+	//! must be held.
+	void materializeOptionalPropertyTypesLocked(PropertyTypeRegistry& registry) {
+		// Cheap when nothing is pending, which is almost always once a snapshot has been taken
+		if (registry.unmaterializedOptionalCount == 0) {
+			return;
+		}
+		// Collect the names first, since adding them while iterating the map would invalidate
+		// the iterators
+		vector<std::string> optionalTypeNames;
+		for (const auto& p : registry.map) {
+			if (p.second.optionalRegistration) {
+				optionalTypeNames.push_back(
+				    std::string{Glass::Private::OptionalPropertyNamePrefix} + p.first);
+			}
+		}
+		for (const auto& typeName : optionalTypeNames) {
+			findLocked(registry, typeName);
+		}
+		registry.unmaterializedOptionalCount = 0;
+	}
+}
+
+const Glass::Private::GlobalPropertyData::PropertyTypeRegistration*
+Glass::Private::GlobalPropertyData::addPropertyTypeRegistration(
+    std::string name, PropertyTypeRegistration registration) {
+	auto& registry = getPropertyTypeRegistry();
+	std::lock_guard<std::mutex> lock{registry.mutex};
+	const auto [it, inserted] = registry.map.emplace(std::move(name), std::move(registration));
+	if (!inserted) {
+		return nullptr;
+	}
+	++registry.generation;
+	if (it->second.optionalRegistration) {
+		++registry.unmaterializedOptionalCount;
+	}
+	return &it->second;
+}
+
+bool Glass::Private::GlobalPropertyData::freezePropertyTypeRegistry() {
+	auto& registry = getPropertyTypeRegistry();
+	std::lock_guard<std::mutex> lock{registry.mutex};
+	materializeOptionalPropertyTypesLocked(registry);
+
+	vector<std::string_view> typeNames;
+	typeNames.reserve(registry.map.size());
+	for (const auto& p : registry.map) {
+		typeNames.emplace_back(p.first);
+	}
+	auto index = PerfectHashIndex::Build(typeNames);
+	if (!index) {
+		ZERROR("Failed to build a perfect hash of the property type names.");
+		return false;
+	}
+
+	vector<FrozenPropertyTypeRegistry::Entry> entries(registry.map.size());
+	for (const auto& p : registry.map) {
+		entries[index->GetSlot(p.first)] = FrozenPropertyTypeRegistry::Entry{p.first, p.second};
+	}
+	registry.frozenRegistries.push_back(make_unique<const FrozenPropertyTypeRegistry>(
+	    FrozenPropertyTypeRegistry{std::move(*index), std::move(entries)}));
+	registry.frozen.store(registry.frozenRegistries.back().get(), std::memory_order_release);
+	return true;
+}
+
+const Glass::Private::GlobalPropertyData::PropertyTypeRegistration*
+Glass::Private::GlobalPropertyData::findPropertyTypeRegistration(std::string_view typeName) {
+	auto& registry = getPropertyTypeRegistry();
+	if (const auto* frozen = registry.frozen.load(std::memory_order_acquire)) {
+		if (const auto* registration = frozen->find(typeName)) {
+			return registration;
+		}
+	}
+
+	// Types registered after the last freeze, or Optional variants that haven't been looked up
+	std::lock_guard<std::mutex> lock{registry.mutex};
+	return findLocked(registry, typeName);
+}
+
+const Glass::Private::GlobalPropertyData::PropertyBinaryCodec*
+Glass::Private::GlobalPropertyData::getPropertyBinaryCodec(std::string_view typeName) {
+	const auto* registration = findPropertyTypeRegistration(typeName);
+	if (!registration || !registration->binaryCodec) {
+		return nullptr;
+	}
+	return &*registration->binaryCodec;
+}
+
+bool Glass::Private::GlobalPropertyData::ensurePropertyTypeRegistered(
+    Util::PropertySerializer& serializer, const std::string& typeName) {
+	if (serializer.IsTypeRegistered(typeName)) {
+		return true;
+	}
+	const auto* registration = findPropertyTypeRegistration(typeName);
+	if (!registration) {
+		return false;
+	}
+	registerPropertyType(serializer, typeName, (registration->serializationData)());
+	return true;
+}
+
+shared_ptr<const Glass::Private::GlobalPropertyData::PropertyTypeRegistrationSnapshot>
+Glass::Private::GlobalPropertyData::getPropertyTypeRegistrationSnapshot() {
+	// Separate from the registry's lock, so that types can be registered and looked up while
+	// a snapshot is being built
+	static std::mutex snapshotMutex;
+	static shared_ptr<const PropertyTypeRegistrationSnapshot> snapshot;
+	static uint64_t snapshotGeneration = 0;
+	std::lock_guard<std::mutex> snapshotLock{snapshotMutex};
+
+	vector<std::pair<std::string_view, const PropertyTypeRegistration*>> registrations;
+	uint64_t generation = 0;
+	{
+		auto& registry = getPropertyTypeRegistry();
+		std::lock_guard<std::mutex> lock{registry.mutex};
+		materializeOptionalPropertyTypesLocked(registry);
+		if (snapshot && snapshotGeneration == registry.generation) {
+			return snapshot;
+		}
+		generation = registry.generation;
+		registrations.reserve(registry.map.size());
+		for (const auto& p : registry.map) {
+			registrations.emplace_back(p.first, &p.second);
+		}
+	}
+
+	auto newSnapshot = make_shared<PropertyTypeRegistrationSnapshot>();
+	newSnapshot->types.reserve(registrations.size());
+	for (const auto& [typeName, registration] : registrations) {
+		newSnapshot->types.emplace_back(std::string{typeName}, (registration->serializationData)());
+	}
+	snapshot = std::move(newSnapshot);
+	snapshotGeneration = generation;
+	return snapshot;
 }
 
 void Glass::Private::GlobalPropertyData::registerGlobalPropertyTypes(
@@ -30,8 +237,11 @@ void Glass::Private::GlobalPropertyData::registerGlobalPropertyTypes(
 	if (serializer.GetDidRegisterTypesForUUID(uuid)) {
 		return;
 	}
-	for (auto& p : getPropertySerializationMap()) {
-		registerPropertyType(serializer, p.first, (p.second)());
+	const auto snapshot = getPropertyTypeRegistrationSnapshot();
+	for (const auto& [typeName, typeData] : snapshot->types) {
+		if (!serializer.IsTypeRegistered(typeName)) {
+			registerPropertyType(serializer, typeName, typeData);
+		}
 	}
 	serializer.SetDidRegisterTypesForUUID(uuid);
 }
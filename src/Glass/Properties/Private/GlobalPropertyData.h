@@ -15,13 +15,18 @@
 
 #pragma once
 
+#include <string_view>
 #include <type_traits>
-#include <unordered_map>
+#include <typeinfo>
 
+#include "gsl/span"
 #include "iZBase/Util/PropertySerializer.h"
 
+#include "Glass/Properties/Private/ValueEquality.h"
 #include "Glass/Properties/Private/getName.h"
 #include "Glass/Properties/Private/has_type.h"
+#include "Glass/Properties/Types/BinaryCodec.h"
+#include "Glass/Properties/Types/Meta.h"
 #include "Glass/Properties/Types/ScratchSpaceAndValue.h"
 
 namespace Util {
@@ -51,19 +56,117 @@ namespace Glass {
 			using PropertyTypeSerializationData =
 			    Util::PropertySerializer::AdvancedTypeRegistrationInfo;
 
-			using PropertySerializationMap =
-			    std::unordered_map<std::string, std::function<PropertyTypeSerializationData()>>;
+			//! Type erased binary codec for a property type (see PropertyType).  `serialize`
+			//! returns false if the value isn't of the registered type.
+			struct PropertyBinaryCodec {
+				std::function<bool(const boost::any&, BinaryWriter&)> serialize;
+				std::function<std::optional<boost::any>(BinaryReader&)> deserialize;
+			};
+
+			//! Type erased batch deserializer for a property type (see PropertyType).  Values
+			//! that fail to deserialize are left empty.
+			using PropertyBatchDeserializeFn =
+			    std::function<void(gsl::span<const std::string_view>,
+			                       gsl::span<std::optional<boost::any>>)>;
+
+			//! Everything registered globally for a single property type
+			struct PropertyTypeRegistration {
+				std::function<PropertyTypeSerializationData()> serializationData;
+				std::optional<PropertyBinaryCodec> binaryCodec;
+				//! typeid of the PropertyType, identifying what `typedData` points to
+				const std::type_info* typeTag = nullptr;
+				//! Points to the TypedPropertyTypeSerializationData<T> of the PropertyType
+				const void* typedData = nullptr;
+				//! Whether deserialize reads the serializer's deserialization context
+				bool hasDeserializationContext = false;
+				//! Empty if the type doesn't have a batch deserializer
+				PropertyBatchDeserializeFn deserializeBatch;
+				//! See SerializeAny
+				std::optional<std::string> (*serialize)(const boost::any& value,
+				                                        const boost::any& scratchSpace) = nullptr;
+				//! See DeserializeInto
+				bool (*deserializeInto)(const std::string& serializedValue,
+				                        const boost::any& context,
+				                        boost::any& value,
+				                        boost::any& scratchSpace) = nullptr;
+				//! See EqualsAny.  nullptr if values of the type can't be compared, in which case
+				//! they can still be compared by their serialized strings.
+				bool (*equals)(const boost::any& lhs, const boost::any& rhs) = nullptr;
+				//! Builds the registration of the Optional variant of this type, if it has one.
+				//! See findPropertyTypeRegistration.
+				PropertyTypeRegistration (*optionalRegistration)() = nullptr;
+			};
+
+			//! Add `registration` to the global property data under `name`.  Returns nullptr,
+			//! leaving the existing registration in place, if `name` is already registered.
+			//! Normally types are registered with AddPropertyTypeData<T>() or
+			//! GLASS_REGISTER_PROPERTY_TYPE instead.
+			//!
+			//! The global property data may be registered with and looked up from any thread,
+			//! for example while plugins run their static initializers on worker threads.
+			//! Registrations are never removed, so the pointers returned by the lookups below
+			//! stay valid for the life of the program.
+			const PropertyTypeRegistration* addPropertyTypeRegistration(
+			    std::string name, PropertyTypeRegistration registration);
+
+			//! Find the global registration of the property type `typeName`, or nullptr if there
+			//! isn't one.  The Optional variants of types registered with
+			//! GLASS_REGISTER_PROPERTY_TYPE aren't added to the map at static initialization;
+			//! each is built from its underlying type's entry the first time it's looked up here.
+			//!
+			//! After freezePropertyTypeRegistry, lookups of the frozen types are lock-free and
+			//! don't allocate.  Other lookups take a lock.
+			const PropertyTypeRegistration* findPropertyTypeRegistration(std::string_view typeName);
+
+			//! Find the binary codec of a globally registered property type.  Returns nullptr if
+			//! the type wasn't registered or doesn't support binary serialization.
+			const PropertyBinaryCodec* getPropertyBinaryCodec(std::string_view typeName);
+
+			//! Compile every type registered so far, including all Optional variants, into an
+			//! immutable table indexed by a perfect hash of the type names, which
+			//! findPropertyTypeRegistration checks before taking the lock around the other
+			//! registrations.  Call this once static initialization is done.  Types registered
+			//! afterwards, such as those of plugins loaded later, are still found, and calling
+			//! this again recompiles the table to include them.  Returns false if the table
+			//! couldn't be built, in which case lookups keep taking the lock.
+			bool freezePropertyTypeRegistry();
+
+			//! Register the globally registered property type `typeName` with `serializer`, unless
+			//! the serializer already has it.  Only the serialization data of this one type is
+			//! built, so a serializer that calls this before looking up a type never pays for the
+			//! types it doesn't use.  Returns false if `typeName` isn't registered globally.
+			//!
+			//! Util::PropertySerializer doesn't call back into Glass when it is asked for a type
+			//! it doesn't have, so this is the lookup: code that owns a serializer must call it
+			//! with each type name before the serializer parses or serializes values of that
+			//! type, e.g. a stylesheet loader with the types of the properties it is about to
+			//! read.  Serializers that are only ever given types this way start out empty.
+			bool ensurePropertyTypeRegistered(Util::PropertySerializer& serializer,
+			                                  const std::string& typeName);
+
+			//! The serialization data of every globally registered property type
+			struct PropertyTypeRegistrationSnapshot {
+				vector<std::pair<std::string, PropertyTypeSerializationData>> types;
+			};
 
-			PropertySerializationMap& getPropertySerializationMap();
+			//! Get the serialization data of every globally registered type, including Optional
+			//! variants.  The snapshot is only rebuilt after new types are registered, so every
+			//! caller in between shares the same one.
+			shared_ptr<const PropertyTypeRegistrationSnapshot>
+			getPropertyTypeRegistrationSnapshot();
 
 			//! Register all property types that have been globally registered for serialization
-			//! with AddPropertyTypeData<T>() or GLASS_REGISTER_PROPERTY_TYPE.
+			//! with AddPropertyTypeData<T>() or GLASS_REGISTER_PROPERTY_TYPE, including Optional
+			//! variants.  This registers every type, so it should only be used where the full
+			//! list of types is needed, like DesignAid; otherwise use
+			//! ensurePropertyTypeRegistered.  The serialization data comes from the shared
+			//! snapshot, so registering many serializers only builds it once.
 			void registerGlobalPropertyTypes(Util::PropertySerializer&);
 
 			//! Register a property type with a property serializer.
 			//! Normally this shouldn't be called directly, but instead proeprties should be
 			//! registered with AddProeprtyTypeData<T>() or GLASS_REGISTER_PROPERTY_TYPE and
-			//! registered with registerGlobalPropertyTypes on startup
+			//! registered with serializers by ensurePropertyTypeRegistered as they are needed
 			void registerPropertyType(Util::PropertySerializer&,
 			                          std::string name,
 			                          PropertyTypeSerializationData data);
@@ -167,7 +270,10 @@ namespace Glass {
 						return boost::none;
 					}
 					auto serialized = std::optional<std::string>(T::serialize(*typedValue));
-					return serialized ? boost::optional<std::string>(*serialized) : boost::none;
+					if (!serialized) {
+						return boost::none;
+					}
+					return boost::optional<std::string>{std::move(*serialized)};
 				};
 				auto deserialize =
 				    [](const std::string& serializedValue,
@@ -222,7 +328,10 @@ namespace Glass {
 					    boost::any_cast<typename T::scratch_type>(&scratch);
 					auto serialized =
 					    std::optional<std::string>(T::serialize(*typedValue, typedScratch));
-					return serialized ? boost::optional<std::string>(*serialized) : boost::none;
+					if (!serialized) {
+						return boost::none;
+					}
+					return boost::optional<std::string>{std::move(*serialized)};
 				};
 				auto deserialize =
 				    [](const std::string& serializedValue,
@@ -280,7 +389,10 @@ namespace Glass {
 						return boost::none;
 					}
 					auto serialized = std::optional<std::string>(T::serialize(*typedValue));
-					return serialized ? boost::optional<std::string>(*serialized) : boost::none;
+					if (!serialized) {
+						return boost::none;
+					}
+					return boost::optional<std::string>{std::move(*serialized)};
 				};
 				auto deserialize = [](const std::string& serializedValue, const boost::any& context)
 				    -> boost::optional<Util::PropertyDeserializationResult> {
@@ -342,7 +454,10 @@ namespace Glass {
 					    boost::any_cast<typename T::scratch_type>(&scratch);
 					auto serialized =
 					    std::optional<std::string>(T::serialize(*typedValue, typedScratch));
-					return serialized ? boost::optional<std::string>(*serialized) : boost::none;
+					if (!serialized) {
+						return boost::none;
+					}
+					return boost::optional<std::string>{std::move(*serialized)};
 				};
 				auto deserialize = [](const std::string& serializedValue, const boost::any& context)
 				    -> boost::optional<Util::PropertyDeserializationResult> {
@@ -374,16 +489,328 @@ namespace Glass {
 			}
 
 
-			template <typename T> void* AddPropertyTypeData(T* = nullptr) {
-				auto& map = getPropertySerializationMap();
-				if (map.find(Private::getName<T>()) != map.end()) {
+			//! Placeholder scratch type for property types without a `scratch_type`
+			struct NoScratchSpace {};
+			//! Placeholder context type for property types without a `context_type`
+			struct NoDeserializationContext {};
+
+			template <typename T, bool = has_type_scratch_type<T>::value> struct ScratchTypeOf {
+				using type = NoScratchSpace;
+			};
+			template <typename T> struct ScratchTypeOf<T, true> {
+				using type = typename T::scratch_type;
+			};
+
+			template <typename T, bool = has_type_context_type<T>::value> struct ContextTypeOf {
+				using type = NoDeserializationContext;
+			};
+			template <typename T> struct ContextTypeOf<T, true> {
+				using type = typename T::context_type;
+			};
+
+			//! Statically typed serialization entry for the property type T.
+			//!
+			//! This is the same as PropertyTypeSerializationData, but as plain function pointers
+			//! over the actual types, so callers that know the type of a property skip the
+			//! std::function dispatch and boost::any boxing of the type erased data.  Every
+			//! kind of serializer is normalized to take a scratch space and a context, which
+			//! are ignored by types that don't use them.
+			template <typename T> struct TypedPropertyTypeSerializationData {
+				using value_type = typename T::type;
+				using scratch_type = typename ScratchTypeOf<T>::type;
+				using context_type = typename ContextTypeOf<T>::type;
+				using DeserializationResult = ScratchSpaceAndValue<scratch_type, value_type>;
+
+				std::optional<std::string> (*serialize)(const value_type&, const scratch_type*);
+				std::optional<DeserializationResult> (*deserialize)(const std::string&,
+				                                                    const context_type*);
+				//! typeid(T)
+				const std::type_info* typeTag;
+			};
+
+			template <typename T> struct TypedSerializers {
+				using Data = TypedPropertyTypeSerializationData<T>;
+
+				static std::optional<std::string>
+				serialize(const typename Data::value_type& value,
+				          const typename Data::scratch_type* scratch) {
+					if constexpr (has_type_scratch_type<T>::value) {
+						return T::serialize(value, scratch);
+					} else {
+						UNREF_PARAM(scratch);
+						return T::serialize(value);
+					}
+				}
+
+				static std::optional<typename Data::DeserializationResult>
+				deserialize(const std::string& serializedValue,
+				            const typename Data::context_type* context) {
+					if constexpr (has_type_scratch_type<T>::value &&
+					              has_type_context_type<T>::value) {
+						return T::deserialize(serializedValue, context);
+					} else if constexpr (has_type_scratch_type<T>::value) {
+						UNREF_PARAM(context);
+						return T::deserialize(serializedValue);
+					} else {
+						std::optional<typename Data::value_type> ret;
+						if constexpr (has_type_context_type<T>::value) {
+							ret = T::deserialize(serializedValue, context);
+						} else {
+							UNREF_PARAM(context);
+							ret = T::deserialize(serializedValue);
+						}
+						if (!ret) {
+							return std::nullopt;
+						}
+						return typename Data::DeserializationResult{std::nullopt, std::move(*ret)};
+					}
+				}
+
+				//! Whether T has an in place deserializer taking its scratch space and context
+				static constexpr bool hasInPlaceDeserialization() {
+					using Scratch = typename Data::scratch_type&;
+					using Context = const typename Data::context_type*;
+					if constexpr (has_type_scratch_type<T>::value &&
+					              has_type_context_type<T>::value) {
+						return HasInPlaceDeserialization_v<T, Scratch, Context>;
+					} else if constexpr (has_type_scratch_type<T>::value) {
+						return HasInPlaceDeserialization_v<T, Scratch>;
+					} else if constexpr (has_type_context_type<T>::value) {
+						return HasInPlaceDeserialization_v<T, Context>;
+					} else {
+						return HasInPlaceDeserialization_v<T>;
+					}
+				}
+
+				//! Call T's in place deserializer, which hasInPlaceDeserialization must allow
+				static bool deserializeInto(const std::string& serializedValue,
+				                            typename Data::value_type& value,
+				                            typename Data::scratch_type& scratch,
+				                            const typename Data::context_type* context) {
+					if constexpr (has_type_scratch_type<T>::value &&
+					              has_type_context_type<T>::value) {
+						return T::deserializeInto(serializedValue, value, scratch, context);
+					} else if constexpr (has_type_scratch_type<T>::value) {
+						UNREF_PARAM(context);
+						return T::deserializeInto(serializedValue, value, scratch);
+					} else if constexpr (has_type_context_type<T>::value) {
+						UNREF_PARAM(scratch);
+						return T::deserializeInto(serializedValue, value, context);
+					} else {
+						UNREF_PARAM(scratch);
+						UNREF_PARAM(context);
+						return T::deserializeInto(serializedValue, value);
+					}
+				}
+			};
+
+			template <typename T>
+			const TypedPropertyTypeSerializationData<T>& GetTypedPropertyTypeSerializationData() {
+				static const TypedPropertyTypeSerializationData<T> data{
+				    &TypedSerializers<T>::serialize, &TypedSerializers<T>::deserialize, &typeid(T)};
+				return data;
+			}
+
+			//! Find the typed serialization data of the globally registered property type
+			//! `typeName`.  Returns nullptr if the type isn't registered or if it was registered
+			//! with a PropertyType other than T.
+			template <typename T>
+			const TypedPropertyTypeSerializationData<T>*
+			findTypedPropertyTypeSerializationData(std::string_view typeName) {
+				const auto* registration = findPropertyTypeRegistration(typeName);
+				if (!registration || !registration->typeTag ||
+				    *registration->typeTag != typeid(T)) {
 					return nullptr;
 				}
-				// Setup property serialization data for T
-				map.emplace(std::make_pair(Private::getName<T>(),
-				                           [] { return GetPropertyTypeSerializationData<T>(); }));
+				return static_cast<const TypedPropertyTypeSerializationData<T>*>(
+				    registration->typedData);
+			}
+
+			//! Binary codecs are only available for types without scratch space or context, since
+			//! neither can be recovered from the encoded value.
+			template <typename T>
+			std::optional<PropertyBinaryCodec> GetPropertyTypeBinaryCodec(T* = nullptr) {
+				if constexpr (HasBinarySerialization_v<T> && !has_type_scratch_type<T>::value &&
+				              !has_type_context_type<T>::value) {
+					auto serialize = [](const boost::any& value, BinaryWriter& writer) -> bool {
+						const typename T::type* typedValue =
+						    boost::any_cast<typename T::type>(&value);
+						if (!typedValue) {
+							ZERROR("Attempting to serialize an invalid type. Type to serialize "
+							       "must be type T.");
+							return false;
+						}
+						T::serializeBinary(*typedValue, writer);
+						return true;
+					};
+					auto deserialize = [](BinaryReader& reader) -> std::optional<boost::any> {
+						auto ret = T::deserializeBinary(reader);
+						if (!ret) {
+							return std::nullopt;
+						}
+						return boost::any{std::move(*ret)};
+					};
+					return PropertyBinaryCodec{std::move(serialize), std::move(deserialize)};
+				} else {
+					return std::nullopt;
+				}
+			}
+
+			//! Deserialize a run of values of the property type T, with T's batch deserializer if
+			//! it has one and one value at a time otherwise.
+			template <typename T>
+			void DeserializeBatch(gsl::span<const std::string_view> serializedValues,
+			                      gsl::span<std::optional<typename T::type>> values) {
+				static_assert(!has_type_scratch_type<T>::value && !has_type_context_type<T>::value,
+				              "Batch deserialization doesn't support scratch space or context");
+				if constexpr (HasBatchDeserialization_v<T>) {
+					T::deserializeBatch(serializedValues, values);
+				} else {
+					auto value = values.begin();
+					for (const auto serializedValue : serializedValues) {
+						*value = T::deserialize(std::string{serializedValue});
+						++value;
+					}
+				}
+			}
 
-				return &map.at(Private::getName<T>());
+			template <typename T>
+			PropertyBatchDeserializeFn GetPropertyTypeBatchDeserializer(T* = nullptr) {
+				if constexpr (HasBatchDeserialization_v<T> && !has_type_scratch_type<T>::value &&
+				              !has_type_context_type<T>::value) {
+					return [](gsl::span<const std::string_view> serializedValues,
+					          gsl::span<std::optional<boost::any>> values) {
+						vector<std::optional<typename T::type>> typedValues(
+						    serializedValues.size());
+						T::deserializeBatch(serializedValues, typedValues);
+						auto value = values.begin();
+						for (auto& typedValue : typedValues) {
+							if (typedValue) {
+								*value = boost::any{std::move(*typedValue)};
+							}
+							++value;
+						}
+					};
+				} else {
+					return {};
+				}
+			}
+
+			//! Store `newValue` in `target`.  If `target` already holds a value of the same type,
+			//! that value is move assigned to rather than replaced, so the boost::any keeps its
+			//! holder.  Storage the value owns, such as a string's buffer, comes from `newValue`.
+			template <typename V> void assignAny(boost::any& target, V&& newValue) {
+				if (auto* existing = boost::any_cast<std::decay_t<V>>(&target)) {
+					*existing = std::forward<V>(newValue);
+				} else {
+					target = std::forward<V>(newValue);
+				}
+			}
+
+			//! Serialize `value` and its scratch space, which is empty if there is none, with the
+			//! serializer of the property type T.  Unlike the type erased serialization data,
+			//! this needs nothing to be built first.
+			template <typename T>
+			std::optional<std::string> SerializeAny(const boost::any& value,
+			                                        const boost::any& scratchSpace) {
+				using Data = TypedPropertyTypeSerializationData<T>;
+				const auto* typedValue = boost::any_cast<typename Data::value_type>(&value);
+				if (!typedValue) {
+					ZERROR("Attempting to serialize an invalid type. Type to serialize must be "
+					       "type T.");
+					return std::nullopt;
+				}
+				return TypedSerializers<T>::serialize(
+				    *typedValue, boost::any_cast<typename Data::scratch_type>(&scratchSpace));
+			}
+
+			//! Deserialize `serializedValue` with the property type T into an existing value and
+			//! scratch space.  If T has an in place deserializer (see PropertyType) and `value`
+			//! already holds a value of T, it is deserialized into, reusing its storage; for
+			//! types with a scratch space, `scratchSpace` must also already hold one, which is
+			//! reused too.  Otherwise a new value and scratch space are deserialized and stored
+			//! with assignAny.  The scratch space is emptied if the deserializer gives none.
+			//! Returns false, leaving both untouched, if deserialization fails.
+			template <typename T>
+			bool DeserializeInto(const std::string& serializedValue,
+			                     const boost::any& context,
+			                     boost::any& value,
+			                     boost::any& scratchSpace) {
+				using Data = TypedPropertyTypeSerializationData<T>;
+				using Serializers = TypedSerializers<T>;
+				const auto* typedContext = boost::any_cast<typename Data::context_type>(&context);
+				if constexpr (Serializers::hasInPlaceDeserialization()) {
+					if (auto* existing = boost::any_cast<typename Data::value_type>(&value)) {
+						if constexpr (has_type_scratch_type<T>::value) {
+							if (auto* existingScratch =
+							        boost::any_cast<typename Data::scratch_type>(&scratchSpace)) {
+								return Serializers::deserializeInto(
+								    serializedValue, *existing, *existingScratch, typedContext);
+							}
+						} else {
+							typename Data::scratch_type noScratchSpace;
+							if (!Serializers::deserializeInto(
+							        serializedValue, *existing, noScratchSpace, typedContext)) {
+								return false;
+							}
+							scratchSpace = boost::any{};
+							return true;
+						}
+					}
+				}
+				auto deserialized = Serializers::deserialize(serializedValue, typedContext);
+				if (!deserialized) {
+					return false;
+				}
+				assignAny(value, std::move(deserialized->value));
+				if (deserialized->scratchSpace) {
+					assignAny(scratchSpace, std::move(*deserialized->scratchSpace));
+				} else {
+					scratchSpace = boost::any{};
+				}
+				return true;
+			}
+
+			//! Whether `lhs` and `rhs` both hold equal values of the property type T (see
+			//! areValuesEqual).  Scratch spaces aren't compared.
+			template <typename T> bool EqualsAny(const boost::any& lhs, const boost::any& rhs) {
+				using Value = typename TypedPropertyTypeSerializationData<T>::value_type;
+				const auto* typedLhs = boost::any_cast<Value>(&lhs);
+				const auto* typedRhs = boost::any_cast<Value>(&rhs);
+				return typedLhs && typedRhs && areValuesEqual(*typedLhs, *typedRhs);
+			}
+
+			template <typename T>
+			bool (*GetPropertyTypeEquals(T* = nullptr))(const boost::any&, const boost::any&) {
+				if constexpr (CanCompareValues_v<typename T::type>) {
+					return &EqualsAny<T>;
+				} else {
+					return nullptr;
+				}
+			}
+
+			template <typename T> PropertyTypeRegistration MakePropertyTypeRegistration() {
+				return PropertyTypeRegistration{
+				    [] { return GetPropertyTypeSerializationData<T>(); },
+				    GetPropertyTypeBinaryCodec<T>(),
+				    &typeid(T),
+				    &GetTypedPropertyTypeSerializationData<T>(),
+				    has_type_context_type<T>::value,
+				    GetPropertyTypeBatchDeserializer<T>(),
+				    &SerializeAny<T>,
+				    &DeserializeInto<T>,
+				    GetPropertyTypeEquals<T>()};
+			}
+
+			//! Register T globally.  `optionalRegistration` should build the registration of
+			//! OptionalProperty<T>, which is then added lazily by findPropertyTypeRegistration.
+			template <typename T>
+			const PropertyTypeRegistration* AddPropertyTypeData(
+			    T* = nullptr, PropertyTypeRegistration (*optionalRegistration)() = nullptr) {
+				// Setup property serialization data for T
+				auto registration = MakePropertyTypeRegistration<T>();
+				registration.optionalRegistration = optionalRegistration;
+				return addPropertyTypeRegistration(Private::getName<T>(), std::move(registration));
 			}
 		}
 	}
@@ -15,11 +15,16 @@
 
 #include "iZBase/common/common.h"
 
+#include <atomic>
+#include <thread>
+
 #include "iZBase/Util/VariantUtils.h"
 #include "Glass/Properties/Types/Builtins.h"
 #include "Glass/Properties/Private/GlobalPropertyData.h"
 #include "Glass/Properties/Private/getName.h"
 #include "Glass/Properties/Types/Builtins.h"
+#include "Glass/Properties/Types/OptionalProperty.h"
+#include "Glass/Properties/Types/VectorProperty.h"
 #include "iZBase/Util/PropertySerializer.h"
 
 IZ_PUSH_ALL_WARNINGS
@@ -41,6 +46,192 @@ TEST(GlobalPropertyTypeRegistration, IntRegistration) {
 	ASSERT_TRUE(serializer.IsTypeRegistered(Glass::IntPropertyType::name));
 }
 
+TEST(GlobalPropertyTypeRegistration, RegistersAllOptionalVariants) {
+	Util::PropertySerializer serializer{};
+
+	Glass::Private::GlobalPropertyData::registerGlobalPropertyTypes(serializer);
+
+	ASSERT_TRUE(serializer.IsTypeRegistered(
+	    Glass::Private::getName<Glass::OptionalProperty<Glass::FloatPropertyType>>()));
+}
+
+TEST(GlobalPropertyTypeRegistration, SharedSnapshot) {
+	using namespace Glass::Private::GlobalPropertyData;
+	const auto snapshot = getPropertyTypeRegistrationSnapshot();
+	ASSERT_EQ(snapshot, getPropertyTypeRegistrationSnapshot());
+	const auto isInSnapshot = [](const auto& snapshot, std::string_view typeName) {
+		return std::any_of(snapshot->types.begin(), snapshot->types.end(), [&](const auto& type) {
+			return type.first == typeName;
+		});
+	};
+	ASSERT_TRUE(isInSnapshot(snapshot, Glass::IntPropertyType::name));
+	ASSERT_TRUE(isInSnapshot(snapshot, "Optional: Int"));
+
+	using NewType = Glass::VectorProperty<Glass::StringPropertyType>;
+	if (AddPropertyTypeData<NewType>()) {
+		const auto newSnapshot = getPropertyTypeRegistrationSnapshot();
+		ASSERT_NE(snapshot, newSnapshot);
+		ASSERT_TRUE(isInSnapshot(newSnapshot, Glass::Private::getName<NewType>()));
+		ASSERT_FALSE(isInSnapshot(snapshot, Glass::Private::getName<NewType>()));
+	}
+
+	Util::PropertySerializer first{};
+	Util::PropertySerializer second{};
+	registerGlobalPropertyTypes(first);
+	registerGlobalPropertyTypes(second);
+	ASSERT_TRUE(first.IsTypeRegistered(Glass::Private::getName<NewType>()));
+	ASSERT_TRUE(second.IsTypeRegistered(Glass::Private::getName<NewType>()));
+}
+
+TEST(GlobalPropertyTypeRegistration, SnapshotIncludesOptionalVariantsOfNewTypes) {
+	using namespace Glass::Private::GlobalPropertyData;
+	using NewType = Glass::VectorProperty<Glass::FloatPropertyType>;
+	using NewOptionalType = Glass::OptionalProperty<NewType>;
+	const auto snapshot = getPropertyTypeRegistrationSnapshot();
+	if (AddPropertyTypeData<NewType>(nullptr, &MakePropertyTypeRegistration<NewOptionalType>)) {
+		const auto newSnapshot = getPropertyTypeRegistrationSnapshot();
+		ASSERT_NE(snapshot, newSnapshot);
+		ASSERT_TRUE(std::any_of(newSnapshot->types.begin(),
+		                        newSnapshot->types.end(),
+		                        [](const auto& type) {
+			                        return type.first == Glass::Private::getName<NewOptionalType>();
+		                        }));
+		// Nothing was registered since, so the snapshot is reused
+		ASSERT_EQ(newSnapshot, getPropertyTypeRegistrationSnapshot());
+	}
+}
+
+TEST(GlobalPropertyTypeRegistration, OnDemandRegistration) {
+	using Glass::Private::GlobalPropertyData::ensurePropertyTypeRegistered;
+	Util::PropertySerializer serializer{};
+
+	ASSERT_TRUE(ensurePropertyTypeRegistered(serializer, Glass::IntPropertyType::name));
+	ASSERT_TRUE(serializer.IsTypeRegistered(Glass::IntPropertyType::name));
+	ASSERT_FALSE(serializer.IsTypeRegistered(Glass::FloatPropertyType::name));
+
+	const auto optionalName =
+	    Glass::Private::getName<Glass::OptionalProperty<Glass::IntPropertyType>>();
+	ASSERT_TRUE(ensurePropertyTypeRegistered(serializer, optionalName));
+	ASSERT_TRUE(serializer.IsTypeRegistered(optionalName));
+
+	ASSERT_FALSE(ensurePropertyTypeRegistered(serializer, "Not a registered type"));
+	ASSERT_FALSE(ensurePropertyTypeRegistered(serializer, "Optional: Not a registered type"));
+	ASSERT_FALSE(serializer.IsTypeRegistered("Not a registered type"));
+}
+
+TEST(GlobalPropertyTypeRegistration, SerializerResolvesTypeOnFirstLookup) {
+	using namespace Glass::Private::GlobalPropertyData;
+	// A serializer created before the type is registered globally, and never given the full
+	// list of types
+	Util::PropertySerializer serializer{};
+	using LateType = Glass::VectorProperty<Glass::IntPropertyType>;
+	const auto lateName = Glass::Private::getName<LateType>();
+	AddPropertyTypeData<LateType>();
+	ASSERT_FALSE(serializer.IsTypeRegistered(lateName));
+
+	ASSERT_TRUE(ensurePropertyTypeRegistered(serializer, lateName));
+	ASSERT_TRUE(serializer.IsTypeRegistered(lateName));
+	ASSERT_FALSE(serializer.IsTypeRegistered(Glass::IntPropertyType::name));
+	// Later lookups find the type already registered with the serializer
+	ASSERT_TRUE(ensurePropertyTypeRegistered(serializer, lateName));
+}
+
+TEST(GlobalPropertyTypeRegistration, OptionalVariantsAreBuiltOnLookup) {
+	using Glass::Private::GlobalPropertyData::findPropertyTypeRegistration;
+	using OptionalBool = Glass::OptionalProperty<Glass::BoolPropertyType>;
+	const auto optionalName = Glass::Private::getName<OptionalBool>();
+	const auto* registration = findPropertyTypeRegistration(optionalName);
+	ASSERT_TRUE(registration);
+	ASSERT_TRUE(registration->typeTag);
+	ASSERT_TRUE(*registration->typeTag == typeid(OptionalBool));
+	ASSERT_EQ(registration, findPropertyTypeRegistration(optionalName));
+	ASSERT_FALSE(findPropertyTypeRegistration("Optional: Optional: Bool"));
+}
+
+TEST(GlobalPropertyTypeRegistration, FrozenRegistry) {
+	using namespace Glass::Private::GlobalPropertyData;
+	ASSERT_TRUE(freezePropertyTypeRegistry());
+
+	const auto* intRegistration = findPropertyTypeRegistration(Glass::IntPropertyType::name);
+	ASSERT_TRUE(intRegistration);
+	ASSERT_TRUE(*intRegistration->typeTag == typeid(Glass::IntPropertyType));
+	const auto optionalName =
+	    Glass::Private::getName<Glass::OptionalProperty<Glass::StringPropertyType>>();
+	ASSERT_TRUE(findPropertyTypeRegistration(optionalName));
+	ASSERT_FALSE(findPropertyTypeRegistration("Not a registered type"));
+
+	// Types registered after freezing are found through the map until the next freeze
+	using LateType = Glass::VectorProperty<Glass::Float4DimPropertyType>;
+	AddPropertyTypeData<LateType>();
+	const auto lateName = Glass::Private::getName<LateType>();
+	const auto* lateRegistration = findPropertyTypeRegistration(lateName);
+	ASSERT_TRUE(lateRegistration);
+	ASSERT_TRUE(*lateRegistration->typeTag == typeid(LateType));
+
+	ASSERT_TRUE(freezePropertyTypeRegistry());
+	ASSERT_TRUE(findPropertyTypeRegistration(lateName));
+	ASSERT_EQ(intRegistration->binaryCodec.has_value(),
+	          findPropertyTypeRegistration(Glass::IntPropertyType::name)->binaryCodec.has_value());
+}
+
+namespace {
+	template <size_t N> struct StressPropertyType : Glass::IntPropertyType {
+		static std::string name() { return "Stress " + std::to_string(N); }
+	};
+
+	constexpr size_t StressPropertyTypeCount = 64;
+
+	template <size_t... N> void addStressPropertyTypes(std::index_sequence<N...>) {
+		(Glass::Private::GlobalPropertyData::AddPropertyTypeData<StressPropertyType<N>>(), ...);
+	}
+}
+
+TEST(GlobalPropertyTypeRegistration, ConcurrentRegistrationAndLookup) {
+	using namespace Glass::Private::GlobalPropertyData;
+	constexpr size_t ThreadCount = 8;
+	std::atomic<bool> failed{false};
+	vector<std::thread> threads;
+	for (size_t i = 0; i < ThreadCount; ++i) {
+		threads.emplace_back([i, &failed] {
+			// Half of the threads race to register the same types, while the others look
+			// them up and register every type with their own serializers
+			if (i % 2 == 0) {
+				addStressPropertyTypes(std::make_index_sequence<StressPropertyTypeCount>{});
+				if (i == 0) {
+					freezePropertyTypeRegistry();
+				}
+			}
+			for (size_t n = 0; n < StressPropertyTypeCount; ++n) {
+				findPropertyTypeRegistration("Stress " + std::to_string(n));
+			}
+			Util::PropertySerializer serializer{};
+			registerGlobalPropertyTypes(serializer);
+			if (!serializer.IsTypeRegistered(Glass::IntPropertyType::name) ||
+			    !findPropertyTypeRegistration("Optional: Int")) {
+				failed = true;
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	ASSERT_FALSE(failed);
+	for (size_t n = 0; n < StressPropertyTypeCount; ++n) {
+		const auto* registration = findPropertyTypeRegistration("Stress " + std::to_string(n));
+		ASSERT_TRUE(registration);
+		ASSERT_TRUE(registration->binaryCodec);
+	}
+}
+
+TEST(GlobalPropertyTypeRegistration, BinaryCodecRegistration) {
+	using Glass::Private::GlobalPropertyData::getPropertyBinaryCodec;
+	ASSERT_TRUE(getPropertyBinaryCodec(Glass::IntPropertyType::name));
+	ASSERT_TRUE(getPropertyBinaryCodec(
+	    Glass::Private::getName<Glass::OptionalProperty<Glass::IntPropertyType>>()));
+	ASSERT_FALSE(getPropertyBinaryCodec("Not a registered type"));
+}
+
 TEST(GlobalPropertyTypeRegistration, EnumPropertyNameRegistration) {
 	Util::PropertySerializer serializer{};
 
@@ -72,6 +263,11 @@ struct TestScratchPropertyType : Glass::PropertyType<int32_t> {
 	}
 };
 
+TEST(GlobalPropertyTypeRegistration, NoBinaryCodecForScratchSpace) {
+	ASSERT_FALSE(Glass::Private::GlobalPropertyData::GetPropertyTypeBinaryCodec<
+	             TestScratchPropertyType>());
+}
+
 TEST(GlobalPropertyTypeRegistration, SupportsScratchSpace) {
 	auto data = Glass::Private::GlobalPropertyData::GetPropertyTypeSerializationData<
 	    TestScratchPropertyType>();
@@ -209,3 +405,215 @@ TEST(GlobalPropertyTypeRegistration, SupportsMultipleKeypathTypes) {
 	ASSERT_TRUE(designAidInfo->canSetKVCValue(KVCAny{&test2}));
 	ASSERT_FALSE(designAidInfo->canSetKVCValue(KVCAny{"I am not a number!"}));
 }
+
+TEST(TypedPropertyTypeSerializationData, Basic) {
+	const auto& data = Glass::Private::GlobalPropertyData::GetTypedPropertyTypeSerializationData<
+	    Glass::IntPropertyType>();
+	ASSERT_EQ(std::string{"36"}, data.serialize(36, nullptr));
+	const auto deserialized = data.deserialize("54", nullptr);
+	ASSERT_TRUE(deserialized);
+	ASSERT_EQ(54, deserialized->value);
+	ASSERT_FALSE(deserialized->scratchSpace);
+}
+
+TEST(TypedPropertyTypeSerializationData, SupportsScratchSpace) {
+	const auto& data = Glass::Private::GlobalPropertyData::GetTypedPropertyTypeSerializationData<
+	    TestScratchPropertyType>();
+	const auto deserialized = data.deserialize("test", nullptr);
+	ASSERT_TRUE(deserialized);
+	ASSERT_EQ(7, deserialized->value);
+	const auto reserialized = data.serialize(deserialized->value, &*deserialized->scratchSpace);
+	ASSERT_EQ(std::string{"hello"}, reserialized);
+}
+
+TEST(TypedPropertyTypeSerializationData, SupportsContext) {
+	const auto& data = Glass::Private::GlobalPropertyData::GetTypedPropertyTypeSerializationData<
+	    TestContextPropertyType>();
+	ASSERT_FALSE(data.deserialize("test", nullptr));
+	const auto context = std::string{"Cool Context"};
+	const auto deserialized = data.deserialize("test", &context);
+	ASSERT_TRUE(deserialized);
+	ASSERT_EQ(43, deserialized->value);
+}
+
+TEST(TypedPropertyTypeSerializationData, SupportsScratchSpaceWithContext) {
+	const auto& data = Glass::Private::GlobalPropertyData::GetTypedPropertyTypeSerializationData<
+	    TestScratchAndContextPropertyType>();
+	const auto context = std::string{"uncool context"};
+	const auto deserialized = data.deserialize("test", &context);
+	ASSERT_TRUE(deserialized);
+	ASSERT_EQ(std::string{"uncool context"}, data.serialize(3008, &*deserialized->scratchSpace));
+}
+
+TEST(TypedPropertyTypeSerializationData, FindChecksTypeTag) {
+	using namespace Glass::Private::GlobalPropertyData;
+	const auto* intData = findTypedPropertyTypeSerializationData<Glass::IntPropertyType>(
+	    Glass::IntPropertyType::name);
+	ASSERT_EQ(&GetTypedPropertyTypeSerializationData<Glass::IntPropertyType>(), intData);
+	ASSERT_FALSE(findTypedPropertyTypeSerializationData<Glass::FloatPropertyType>(
+	    Glass::IntPropertyType::name));
+	ASSERT_FALSE(findTypedPropertyTypeSerializationData<Glass::IntPropertyType>(
+	    "Not a registered type"));
+}
+
+namespace {
+	//! Counts its copies, so tests can check that values are moved through serialization
+	struct CopyCounted {
+		CopyCounted() = default;
+		explicit CopyCounted(std::string text)
+		    : text{std::move(text)} {}
+		CopyCounted(const CopyCounted& other)
+		    : text{other.text} {
+			++copies;
+		}
+		CopyCounted(CopyCounted&&) = default;
+		CopyCounted& operator=(const CopyCounted& other) {
+			text = other.text;
+			++copies;
+			return *this;
+		}
+		CopyCounted& operator=(CopyCounted&&) = default;
+
+		std::string text;
+		static inline size_t copies = 0;
+	};
+
+	//! Long enough to be heap allocated, so a string that is moved keeps its buffer
+	const std::string LargeText(1000, 'x');
+	//! Buffer of the last string returned by CopyCountedPropertyType::serialize
+	const char* g_serializedBuffer = nullptr;
+
+	struct CopyCountedPropertyType : Glass::PropertyType<CopyCounted> {
+		static constexpr auto name = "CopyCounted";
+		using scratch_type = CopyCounted;
+		static std::optional<std::string> serialize(const CopyCounted& value,
+		                                            const CopyCounted*) {
+			std::optional<std::string> serialized{value.text};
+			g_serializedBuffer = serialized->data();
+			return serialized;
+		}
+		static std::optional<Glass::ScratchSpaceAndValue<CopyCounted, CopyCounted>>
+		deserialize(const std::string& serializedValue) {
+			return Glass::ScratchSpaceAndValue<CopyCounted, CopyCounted>{
+			    CopyCounted{serializedValue}, CopyCounted{serializedValue}};
+		}
+	};
+
+	using OptionalCopyCountedPropertyType = Glass::OptionalProperty<CopyCountedPropertyType>;
+}
+
+TEST(GlobalPropertyTypeRegistration, DeserializeDoesntCopy) {
+	const auto data = Glass::Private::GlobalPropertyData::GetPropertyTypeSerializationData<
+	    CopyCountedPropertyType>();
+	const auto optionalData = Glass::Private::GlobalPropertyData::GetPropertyTypeSerializationData<
+	    OptionalCopyCountedPropertyType>();
+	CopyCounted::copies = 0;
+
+	auto deserialized = data.deserialize(LargeText, boost::any{});
+	ASSERT_TRUE(deserialized);
+	ASSERT_EQ(LargeText, boost::any_cast<CopyCounted&>(deserialized->value).text);
+	ASSERT_EQ(LargeText, boost::any_cast<CopyCounted&>(deserialized->scratchSpace).text);
+
+	auto optionalDeserialized = optionalData.deserialize(LargeText, boost::any{});
+	ASSERT_TRUE(optionalDeserialized);
+	ASSERT_EQ(LargeText,
+	          boost::any_cast<std::optional<CopyCounted>&>(optionalDeserialized->value)->text);
+
+	const auto& typedData =
+	    Glass::Private::GlobalPropertyData::GetTypedPropertyTypeSerializationData<
+	        CopyCountedPropertyType>();
+	ASSERT_TRUE(typedData.deserialize(LargeText, nullptr));
+
+	boost::any value;
+	boost::any scratchSpace;
+	ASSERT_TRUE(Glass::Private::GlobalPropertyData::DeserializeInto<CopyCountedPropertyType>(
+	    LargeText, boost::any{}, value, scratchSpace));
+	ASSERT_TRUE(Glass::Private::GlobalPropertyData::DeserializeInto<CopyCountedPropertyType>(
+	    LargeText, boost::any{}, value, scratchSpace));
+
+	ASSERT_EQ(0u, CopyCounted::copies);
+}
+
+TEST(GlobalPropertyTypeRegistration, SerializeDoesntCopy) {
+	const auto data = Glass::Private::GlobalPropertyData::GetPropertyTypeSerializationData<
+	    CopyCountedPropertyType>();
+	const auto optionalData = Glass::Private::GlobalPropertyData::GetPropertyTypeSerializationData<
+	    OptionalCopyCountedPropertyType>();
+	const boost::any value{CopyCounted{LargeText}};
+	const boost::any optionalValue{std::optional<CopyCounted>{CopyCounted{LargeText}}};
+	CopyCounted::copies = 0;
+
+	// The serialized string is moved all the way out, so it keeps the buffer it was built in
+	const auto serialized = data.serialize(value, boost::any{});
+	ASSERT_TRUE(serialized);
+	ASSERT_EQ(g_serializedBuffer, serialized->data());
+
+	const auto optionalSerialized = optionalData.serialize(optionalValue, boost::any{});
+	ASSERT_TRUE(optionalSerialized);
+	ASSERT_EQ(g_serializedBuffer, optionalSerialized->data());
+
+	const auto erasedSerialized =
+	    Glass::Private::GlobalPropertyData::SerializeAny<CopyCountedPropertyType>(value,
+	                                                                              boost::any{});
+	ASSERT_TRUE(erasedSerialized);
+	ASSERT_EQ(g_serializedBuffer, erasedSerialized->data());
+
+	ASSERT_EQ(0u, CopyCounted::copies);
+}
+
+TEST(GlobalPropertyTypeRegistration, DeserializeIntoReusesStorage) {
+	using Glass::Private::GlobalPropertyData::DeserializeInto;
+	boost::any value{std::string{}};
+	boost::any scratchSpace;
+	ASSERT_TRUE(DeserializeInto<Glass::StringPropertyType>(
+	    LargeText, boost::any{}, value, scratchSpace));
+	const auto* buffer = boost::any_cast<std::string&>(value).data();
+
+	const std::string shorterText(LargeText.size() / 2, 'b');
+	ASSERT_TRUE(DeserializeInto<Glass::StringPropertyType>(
+	    shorterText, boost::any{}, value, scratchSpace));
+	ASSERT_EQ(shorterText, boost::any_cast<std::string&>(value));
+	ASSERT_EQ(buffer, boost::any_cast<std::string&>(value).data());
+	ASSERT_TRUE(scratchSpace.empty());
+}
+
+namespace {
+	//! Keeps the text doubled in its scratch space, and deserializes into both in place
+	struct TestInPlaceScratchPropertyType : Glass::PropertyType<std::string> {
+		static constexpr auto name = "TestInPlaceScratch";
+		using scratch_type = std::string;
+		static std::optional<std::string> serialize(const std::string& value, const std::string*) {
+			return value;
+		}
+		static std::optional<Glass::ScratchSpaceAndValue<scratch_type, type>>
+		deserialize(const std::string& serializedValue) {
+			return Glass::ScratchSpaceAndValue<scratch_type, type>{
+			    serializedValue + serializedValue, serializedValue};
+		}
+		static bool deserializeInto(const std::string& serializedValue,
+		                            std::string& value,
+		                            std::string& scratch) {
+			value.assign(serializedValue);
+			scratch.assign(serializedValue).append(serializedValue);
+			return true;
+		}
+	};
+}
+
+TEST(GlobalPropertyTypeRegistration, DeserializeIntoReusesScratchSpace) {
+	using Glass::Private::GlobalPropertyData::DeserializeInto;
+	boost::any value;
+	boost::any scratchSpace;
+	ASSERT_TRUE(DeserializeInto<TestInPlaceScratchPropertyType>(
+	    LargeText, boost::any{}, value, scratchSpace));
+	const auto* buffer = boost::any_cast<std::string&>(value).data();
+	const auto* scratchBuffer = boost::any_cast<std::string&>(scratchSpace).data();
+
+	const std::string shorterText(LargeText.size() / 2, 'b');
+	ASSERT_TRUE(DeserializeInto<TestInPlaceScratchPropertyType>(
+	    shorterText, boost::any{}, value, scratchSpace));
+	ASSERT_EQ(shorterText, boost::any_cast<std::string&>(value));
+	ASSERT_EQ(shorterText + shorterText, boost::any_cast<std::string&>(scratchSpace));
+	ASSERT_EQ(buffer, boost::any_cast<std::string&>(value).data());
+	ASSERT_EQ(scratchBuffer, boost::any_cast<std::string&>(scratchSpace).data());
+}
@@ -106,7 +106,15 @@
 
 #define GLASS_U_P_X(...)                                                                           \
 	using __VA_ARGS__::GetProperty;                                                                \
+	using __VA_ARGS__::GetPropertyRef;                                                             \
 	using __VA_ARGS__::SetProperty;                                                                \
+	using __VA_ARGS__::EmplaceProperty;                                                            \
+	using __VA_ARGS__::ModifyProperty;                                                             \
+	using __VA_ARGS__::ConsumeDirty;                                                               \
+	using __VA_ARGS__::GetChangedSince;                                                            \
+	using __VA_ARGS__::DiffProperties;                                                             \
+	using __VA_ARGS__::Snapshot;                                                                   \
+	using __VA_ARGS__::Restore;                                                                    \
 	using __VA_ARGS__::didSet;
 
 #define CALL_GLASS_U_P_X(R, Data, Elem) GLASS_U_P_X Elem
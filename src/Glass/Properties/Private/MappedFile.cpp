@@ -0,0 +1,121 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/Private/MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using Glass::Private::MappedFile;
+
+#ifdef _WIN32
+std::optional<MappedFile> MappedFile::Open(const std::string& path) {
+	HANDLE file = CreateFileA(path.c_str(),
+	                          GENERIC_READ,
+	                          FILE_SHARE_READ,
+	                          nullptr,
+	                          OPEN_EXISTING,
+	                          FILE_ATTRIBUTE_NORMAL,
+	                          nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return std::nullopt;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return std::nullopt;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	// The mapping keeps the file open, so we don't need the file handle anymore
+	CloseHandle(file);
+	if (!mapping) {
+		return std::nullopt;
+	}
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		CloseHandle(mapping);
+		return std::nullopt;
+	}
+	return MappedFile{
+	    static_cast<const uint8_t*>(data), static_cast<size_t>(size.QuadPart), mapping};
+}
+
+void MappedFile::close() {
+	if (m_data) {
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping) {
+		CloseHandle(m_mapping);
+	}
+}
+#else
+std::optional<MappedFile> MappedFile::Open(const std::string& path) {
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return std::nullopt;
+	}
+	struct stat fileInfo;
+	if (::fstat(fd, &fileInfo) != 0 || fileInfo.st_size == 0) {
+		::close(fd);
+		return std::nullopt;
+	}
+	const auto size = static_cast<size_t>(fileInfo.st_size);
+	void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps the file open, so we don't need the file descriptor anymore
+	::close(fd);
+	if (data == MAP_FAILED) {
+		return std::nullopt;
+	}
+	return MappedFile{static_cast<const uint8_t*>(data), size, nullptr};
+}
+
+void MappedFile::close() {
+	if (m_data) {
+		::munmap(const_cast<uint8_t*>(m_data), m_size);
+	}
+}
+#endif
+
+MappedFile::MappedFile(const uint8_t* data, size_t size, void* mapping)
+    : m_data{data}
+    , m_size{size}
+    , m_mapping{mapping} {}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}
+    , m_size{std::exchange(other.m_size, 0)}
+    , m_mapping{std::exchange(other.m_mapping, nullptr)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		close();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
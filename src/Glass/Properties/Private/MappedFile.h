@@ -0,0 +1,49 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace Glass {
+	namespace Private {
+		//! Read-only memory mapping of an entire file
+		class MappedFile {
+		public:
+			//! Returns std::nullopt if the file doesn't exist, is empty, or can't be mapped.
+			static std::optional<MappedFile> Open(const std::string& path);
+
+			MappedFile(MappedFile&&) noexcept;
+			MappedFile& operator=(MappedFile&&) noexcept;
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+			~MappedFile();
+
+			const uint8_t* GetData() const { return m_data; }
+			size_t GetSize() const { return m_size; }
+
+		private:
+			MappedFile(const uint8_t* data, size_t size, void* mapping);
+			void close();
+
+			const uint8_t* m_data = nullptr;
+			size_t m_size = 0;
+			//! Platform mapping handle, only used on Windows
+			void* m_mapping = nullptr;
+		};
+	}
+}
@@ -0,0 +1,85 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/Private/PerfectHash.h"
+
+#include <algorithm>
+#include <numeric>
+
+using Glass::Private::PerfectHashIndex;
+
+namespace {
+	// Each bucket holds two names on average.  Larger buckets make the index smaller but the
+	// build slower; the registries this is used for are small enough that size doesn't matter.
+	constexpr size_t NamesPerBucket = 2;
+	constexpr uint32_t MaxSeed = 1 << 16;
+}
+
+std::optional<PerfectHashIndex> PerfectHashIndex::Build(const vector<std::string_view>& names) {
+	const auto size = names.size();
+	const auto bucketCount = std::max<size_t>(1, size / NamesPerBucket);
+
+	vector<vector<std::string_view>> buckets(bucketCount);
+	for (const auto name : names) {
+		buckets[hashName(name, 0) % bucketCount].push_back(name);
+	}
+
+	// Place the largest buckets first, while there are still many free slots
+	vector<size_t> bucketOrder(bucketCount);
+	std::iota(bucketOrder.begin(), bucketOrder.end(), size_t{0});
+	std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&](size_t a, size_t b) {
+		return buckets[a].size() > buckets[b].size();
+	});
+
+	vector<uint32_t> seeds(bucketCount, 0);
+	vector<bool> isSlotUsed(size, false);
+	vector<size_t> bucketSlots;
+	for (const auto bucket : bucketOrder) {
+		if (buckets[bucket].empty()) {
+			break;
+		}
+		auto tryPlaceBucket = [&](uint32_t seed) {
+			bucketSlots.clear();
+			for (const auto name : buckets[bucket]) {
+				const auto slot = hashName(name, seed) % size;
+				if (isSlotUsed[slot] ||
+				    std::find(bucketSlots.begin(), bucketSlots.end(), slot) != bucketSlots.end()) {
+					return false;
+				}
+				bucketSlots.push_back(slot);
+			}
+			return true;
+		};
+
+		uint32_t seed = 1;
+		while (seed < MaxSeed && !tryPlaceBucket(seed)) {
+			++seed;
+		}
+		if (seed == MaxSeed) {
+			return std::nullopt;
+		}
+		seeds[bucket] = seed;
+		for (const auto slot : bucketSlots) {
+			isSlotUsed[slot] = true;
+		}
+	}
+	return PerfectHashIndex{std::move(seeds), size};
+}
+
+PerfectHashIndex::PerfectHashIndex(vector<uint32_t> seeds, size_t size)
+    : m_seeds{std::move(seeds)}
+    , m_size{size} {}
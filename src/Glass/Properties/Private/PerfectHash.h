@@ -0,0 +1,190 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace Glass {
+	namespace Private {
+		//! Seeded 64 bit FNV-1a, with a final mix so that the low bits are usable as an index
+		constexpr uint64_t hashName(std::string_view name, uint64_t seed) {
+			uint64_t hash = 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull);
+			for (const char c : name) {
+				hash ^= static_cast<uint8_t>(c);
+				hash *= 1099511628211ull;
+			}
+			hash ^= hash >> 32;
+			hash *= 0xd6e8feb86659fd93ull;
+			hash ^= hash >> 32;
+			return hash;
+		}
+
+		//! Combine the hash of a name with a seed.  Cheaper than hashing the name again with a
+		//! different seed, since it doesn't depend on the length of the name.
+		constexpr uint64_t rehash(uint64_t hash, uint64_t seed) {
+			hash ^= seed * 0x9e3779b97f4a7c15ull;
+			hash ^= hash >> 29;
+			hash *= 0xbf58476d1ce4e5b9ull;
+			hash ^= hash >> 32;
+			return hash;
+		}
+
+		//! Minimal perfect hash over a fixed set of distinct names, built with hash and
+		//! displace: each name is first hashed into a bucket, and each bucket stores the seed
+		//! that sends all of its names to distinct free slots.  A lookup is two hashes and never
+		//! probes.
+		class PerfectHashIndex {
+		public:
+			//! Build an index over `names`, which must be distinct.  Returns std::nullopt if no
+			//! perfect hash was found, which is not expected in practice.
+			static std::optional<PerfectHashIndex> Build(const vector<std::string_view>& names);
+
+			//! The slot in [0, GetSize()) of `name`.  Names that weren't given to Build map to an
+			//! arbitrary slot, so callers must compare the name stored in that slot.  Must not be
+			//! called on an empty index.
+			size_t GetSlot(std::string_view name) const {
+				const auto bucket = hashName(name, 0) % m_seeds.size();
+				return hashName(name, m_seeds[bucket]) % m_size;
+			}
+
+			size_t GetSize() const { return m_size; }
+
+		private:
+			PerfectHashIndex(vector<uint32_t> seeds, size_t size);
+
+			vector<uint32_t> m_seeds;
+			size_t m_size;
+		};
+
+		//! Whether any two of `names` are equal
+		template <size_t N>
+		constexpr bool hasDuplicateNames(const std::array<std::string_view, N>& names) {
+			for (size_t i = 0; i < N; ++i) {
+				for (size_t j = i + 1; j < N; ++j) {
+					if (names[i] == names[j]) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+
+		//! Minimal perfect hash over N distinct names known at compile time, built in a
+		//! constant expression by BuildStaticPerfectHashIndex.  This is the same hash and
+		//! displace scheme as PerfectHashIndex, except that each bucket's seed is combined
+		//! with the name's hash using rehash, so a lookup hashes the name only once.
+		template <size_t N> struct StaticPerfectHashIndex {
+			static constexpr size_t BucketCount = N / 2 > 0 ? N / 2 : 1;
+
+			//! The index in the names given to BuildStaticPerfectHashIndex of the name that
+			//! may be `name`, which callers must compare.  Must not be called if N is 0.
+			constexpr size_t GetNameIndex(std::string_view name) const {
+				const auto hash = hashName(name, 0);
+				return slotNames[rehash(hash, seeds[hash % BucketCount]) % N];
+			}
+
+			std::array<uint32_t, BucketCount> seeds{};
+			//! The index of the name in each slot
+			std::array<size_t, N> slotNames{};
+			//! False if no perfect hash was found
+			bool isValid = false;
+		};
+
+		template <size_t N>
+		constexpr StaticPerfectHashIndex<N>
+		BuildStaticPerfectHashIndex(const std::array<std::string_view, N>& names) {
+			using Index = StaticPerfectHashIndex<N>;
+			constexpr auto BucketCount = Index::BucketCount;
+			constexpr uint32_t MaxSeed = 1 << 16;
+			Index index{};
+			if constexpr (N == 0) {
+				static_cast<void>(names);
+				index.isValid = true;
+				return index;
+			} else {
+				// Sort the names by bucket, so each bucket's names are contiguous in bucketNames
+				std::array<uint64_t, N> hashes{};
+				std::array<size_t, BucketCount + 1> bucketStarts{};
+				for (size_t i = 0; i < N; ++i) {
+					hashes[i] = hashName(names[i], 0);
+					++bucketStarts[hashes[i] % BucketCount + 1];
+				}
+				for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+					bucketStarts[bucket + 1] += bucketStarts[bucket];
+				}
+				std::array<size_t, N> bucketNames{};
+				std::array<size_t, BucketCount> bucketSizes{};
+				for (size_t i = 0; i < N; ++i) {
+					const auto bucket = hashes[i] % BucketCount;
+					bucketNames[bucketStarts[bucket] + bucketSizes[bucket]++] = i;
+				}
+
+				// Place the largest buckets first, while there are still many free slots
+				std::array<size_t, BucketCount> bucketOrder{};
+				for (size_t i = 0; i < BucketCount; ++i) {
+					auto j = i;
+					for (; j > 0 && bucketSizes[bucketOrder[j - 1]] < bucketSizes[i]; --j) {
+						bucketOrder[j] = bucketOrder[j - 1];
+					}
+					bucketOrder[j] = i;
+				}
+
+				std::array<bool, N> isSlotUsed{};
+				std::array<size_t, N> bucketSlots{};
+				for (const auto bucket : bucketOrder) {
+					const auto begin = bucketStarts[bucket];
+					const auto end = bucketStarts[bucket + 1];
+					if (begin == end) {
+						break;
+					}
+					auto tryPlaceBucket = [&](uint32_t seed) {
+						for (auto i = begin; i < end; ++i) {
+							const auto slot = rehash(hashes[bucketNames[i]], seed) % N;
+							if (isSlotUsed[slot]) {
+								return false;
+							}
+							for (auto j = begin; j < i; ++j) {
+								if (bucketSlots[j - begin] == slot) {
+									return false;
+								}
+							}
+							bucketSlots[i - begin] = slot;
+						}
+						return true;
+					};
+
+					uint32_t seed = 1;
+					while (seed < MaxSeed && !tryPlaceBucket(seed)) {
+						++seed;
+					}
+					if (seed == MaxSeed) {
+						return index;
+					}
+					index.seeds[bucket] = seed;
+					for (auto i = begin; i < end; ++i) {
+						isSlotUsed[bucketSlots[i - begin]] = true;
+						index.slotNames[bucketSlots[i - begin]] = bucketNames[i];
+					}
+				}
+				index.isValid = true;
+				return index;
+			}
+		}
+	}
+}
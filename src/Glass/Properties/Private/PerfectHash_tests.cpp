@@ -0,0 +1,103 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include <set>
+
+#include "Glass/Properties/Private/PerfectHash.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+using Glass::Private::PerfectHashIndex;
+
+TEST(PerfectHash, HashDependsOnSeed) {
+	static_assert(Glass::Private::hashName("Int", 0) == Glass::Private::hashName("Int", 0));
+	ASSERT_NE(Glass::Private::hashName("Int", 0), Glass::Private::hashName("Int", 1));
+	ASSERT_NE(Glass::Private::hashName("Int", 0), Glass::Private::hashName("Float", 0));
+}
+
+TEST(PerfectHash, SlotsAreDistinct) {
+	vector<std::string> storage;
+	for (int i = 0; i < 500; ++i) {
+		storage.push_back("Type" + std::to_string(i));
+	}
+	const vector<std::string_view> names(storage.begin(), storage.end());
+
+	const auto index = PerfectHashIndex::Build(names);
+	ASSERT_TRUE(index);
+	ASSERT_EQ(names.size(), index->GetSize());
+	std::set<size_t> slots;
+	for (const auto name : names) {
+		const auto slot = index->GetSlot(name);
+		ASSERT_LT(slot, names.size());
+		slots.insert(slot);
+	}
+	ASSERT_EQ(names.size(), slots.size());
+}
+
+TEST(PerfectHash, SingleName) {
+	const auto index = PerfectHashIndex::Build({"Int"});
+	ASSERT_TRUE(index);
+	ASSERT_EQ(0u, index->GetSlot("Int"));
+	ASSERT_EQ(0u, index->GetSlot("Not a registered type"));
+}
+
+TEST(PerfectHash, DuplicateNamesFail) {
+	ASSERT_FALSE(PerfectHashIndex::Build({"Int", "Float", "Int"}));
+}
+
+TEST(PerfectHash, StaticIndex) {
+	constexpr std::array<std::string_view, 5> names{"Int", "Float", "Bool", "String", "Color"};
+	constexpr auto index = Glass::Private::BuildStaticPerfectHashIndex(names);
+	static_assert(index.isValid);
+	static_assert(index.GetNameIndex("String") == 3);
+	for (size_t i = 0; i < names.size(); ++i) {
+		ASSERT_EQ(i, index.GetNameIndex(names[i]));
+	}
+	ASSERT_LT(index.GetNameIndex("Not a name"), names.size());
+
+	static_assert(Glass::Private::BuildStaticPerfectHashIndex(std::array<std::string_view, 0>{})
+	                  .isValid);
+	static_assert(Glass::Private::BuildStaticPerfectHashIndex(std::array<std::string_view, 1>{
+	                                                              "Int"})
+	                  .GetNameIndex("Int") == 0);
+}
+
+TEST(PerfectHash, StaticIndexSlotsAreDistinct) {
+	constexpr size_t NameCount = 300;
+	vector<std::string> storage;
+	std::array<std::string_view, NameCount> names{};
+	storage.reserve(NameCount);
+	for (size_t i = 0; i < NameCount; ++i) {
+		storage.push_back("Property " + std::to_string(i));
+		names[i] = storage.back();
+	}
+
+	const auto index = Glass::Private::BuildStaticPerfectHashIndex(names);
+	ASSERT_TRUE(index.isValid);
+	for (size_t i = 0; i < NameCount; ++i) {
+		ASSERT_EQ(i, index.GetNameIndex(names[i]));
+	}
+}
+
+TEST(PerfectHash, DuplicateNamesAreDetected) {
+	static_assert(!Glass::Private::hasDuplicateNames(
+	    std::array<std::string_view, 3>{"Int", "Float", "Bool"}));
+	static_assert(Glass::Private::hasDuplicateNames(
+	    std::array<std::string_view, 3>{"Int", "Float", "Int"}));
+}
@@ -32,11 +32,26 @@ namespace Glass::Private {
 	                         GlobalPropertyData::GetPropertyTypeSerializationData<T>())>>
 	    : std::true_type {};
 
-	template <typename T> struct RegisterPropertyType {
+	//! Registers T globally at static initialization.  If OptionalT is given, it's registered
+	//! as the Optional variant of T, which is only built when it's first looked up.
+	template <typename T, typename OptionalT = void> struct RegisterPropertyType {
+		static auto getOptionalRegistration() {
+			using GlobalPropertyData::PropertyTypeRegistration;
+			PropertyTypeRegistration (*optionalRegistration)() = nullptr;
+			if constexpr (!std::is_void_v<OptionalT>) {
+				if constexpr (ShouldRegisterPropertyType<OptionalT>::value) {
+					optionalRegistration =
+					    &GlobalPropertyData::MakePropertyTypeRegistration<OptionalT>;
+				}
+			}
+			return optionalRegistration;
+		}
+
 		struct StaticRegistration {
 			StaticRegistration() {
 				if constexpr (ShouldRegisterPropertyType<T>::value) {
-					Glass::Private::GlobalPropertyData::AddPropertyTypeData<T>();
+					Glass::Private::GlobalPropertyData::AddPropertyTypeData<T>(
+					    nullptr, getOptionalRegistration());
 				}
 			}
 		};
@@ -47,7 +62,7 @@ namespace Glass::Private {
 		static const StaticRegistrationRef<staticRegistration> staticRegistrationRef;
 	};
 
-	template <typename T>
-	const typename RegisterPropertyType<T>::StaticRegistration
-	    RegisterPropertyType<T>::staticRegistration;
+	template <typename T, typename OptionalT>
+	const typename RegisterPropertyType<T, OptionalT>::StaticRegistration
+	    RegisterPropertyType<T, OptionalT>::staticRegistration;
 }
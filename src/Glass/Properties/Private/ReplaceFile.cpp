@@ -0,0 +1,95 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/Private/ReplaceFile.h"
+
+#include <filesystem>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+bool Glass::Private::replaceFile(const std::string& source, const std::string& destination) {
+	// Unlike rename, MoveFileEx can replace an existing file, and MOVEFILE_WRITE_THROUGH waits
+	// for the move to reach the disk
+	return MoveFileExW(std::filesystem::path{source}.c_str(),
+	                   std::filesystem::path{destination}.c_str(),
+	                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+bool Glass::Private::syncFile(const std::string& path) {
+	// FlushFileBuffers needs write access
+	const auto file = CreateFileW(std::filesystem::path{path}.c_str(),
+	                              GENERIC_WRITE,
+	                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+	                              nullptr,
+	                              OPEN_EXISTING,
+	                              FILE_ATTRIBUTE_NORMAL,
+	                              nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	const bool didSync = FlushFileBuffers(file) != 0;
+	CloseHandle(file);
+	return didSync;
+}
+#else
+namespace {
+	bool syncDescriptor(int descriptor) {
+#ifdef __APPLE__
+		// fsync only reaches the drive's cache on macOS
+		if (fcntl(descriptor, F_FULLFSYNC) == 0) {
+			return true;
+		}
+#endif
+		return fsync(descriptor) == 0;
+	}
+
+	bool syncPath(const std::string& path, int flags) {
+		const int descriptor = open(path.c_str(), flags);
+		if (descriptor < 0) {
+			return false;
+		}
+		const bool didSync = syncDescriptor(descriptor);
+		close(descriptor);
+		return didSync;
+	}
+}
+
+bool Glass::Private::replaceFile(const std::string& source, const std::string& destination) {
+	if (std::rename(source.c_str(), destination.c_str()) != 0) {
+		return false;
+	}
+	// The rename is only durable once the directory entry is
+	auto directory = std::filesystem::path{destination}.parent_path();
+	if (directory.empty()) {
+		directory = ".";
+	}
+	syncPath(directory.string(), O_RDONLY | O_DIRECTORY);
+	return true;
+}
+
+bool Glass::Private::syncFile(const std::string& path) {
+	return syncPath(path, O_RDONLY);
+}
+#endif
@@ -0,0 +1,35 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include <string>
+
+namespace Glass {
+	namespace Private {
+		//! Atomically replace `destination` with `source`, so a crash leaves either the old or the
+		//! new file at `destination`.  Returns false if it couldn't be replaced, in which case
+		//! both files are left as they were.  `source` should have been synced with syncFile
+		//! first, or a power loss may leave `destination` empty or truncated.  On POSIX the
+		//! directory holding `destination` is synced afterwards, on a best effort basis, so the
+		//! replacement itself survives a power loss.
+		bool replaceFile(const std::string& source, const std::string& destination);
+
+		//! Flush the contents of the file at `path` from the operating system's caches to disk.
+		//! Returns false if the file couldn't be opened or flushed.
+		bool syncFile(const std::string& path);
+	}
+}
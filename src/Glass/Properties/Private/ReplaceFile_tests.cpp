@@ -0,0 +1,76 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include "Glass/Properties/Private/ReplaceFile.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+namespace {
+	using Glass::Private::replaceFile;
+	using Glass::Private::syncFile;
+
+	class ReplaceFileTests : public ::testing::Test {
+	public:
+		void TearDown() override {
+			std::remove(source.c_str());
+			std::remove(destination.c_str());
+		}
+
+		static void writeFile(const std::string& path, const std::string& contents) {
+			std::ofstream file{path, std::ios::binary | std::ios::trunc};
+			file << contents;
+		}
+
+		static std::string readFile(const std::string& path) {
+			std::ifstream file{path, std::ios::binary};
+			std::string contents;
+			std::getline(file, contents);
+			return contents;
+		}
+
+		const std::string source = ::testing::TempDir() + "ReplaceFileTests.source";
+		const std::string destination = ::testing::TempDir() + "ReplaceFileTests.destination";
+	};
+
+	TEST_F(ReplaceFileTests, ReplacesExistingFile) {
+		writeFile(source, "new");
+		writeFile(destination, "old");
+		ASSERT_TRUE(replaceFile(source, destination));
+		ASSERT_EQ(std::string{"new"}, readFile(destination));
+		ASSERT_FALSE(std::ifstream{source}.is_open());
+	}
+
+	TEST_F(ReplaceFileTests, FailureLeavesDestination) {
+		std::remove(source.c_str());
+		writeFile(destination, "old");
+		ASSERT_FALSE(replaceFile(source, destination));
+		ASSERT_EQ(std::string{"old"}, readFile(destination));
+	}
+
+	TEST_F(ReplaceFileTests, SyncFile) {
+		writeFile(source, "new");
+		ASSERT_TRUE(syncFile(source));
+		std::remove(source.c_str());
+		ASSERT_FALSE(syncFile(source));
+	}
+}
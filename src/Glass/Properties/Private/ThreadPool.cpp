@@ -0,0 +1,186 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/Private/ThreadPool.h"
+
+#include <atomic>
+#include <deque>
+#include <optional>
+
+using Glass::Private::WorkStealingThreadPool;
+
+namespace {
+	//! Chunks dealt to each participating thread.  More chunks balance uneven work better, at
+	//! the cost of more time spent taking chunks.
+	constexpr size_t ChunksPerThread = 4;
+
+	//! Set on worker threads, and on a thread while it runs a loop, to run nested loops serially
+	thread_local bool t_isInParallelFor = false;
+}
+
+struct WorkStealingThreadPool::Loop {
+	struct Chunk {
+		size_t begin;
+		size_t end;
+	};
+
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Chunk> chunks;
+	};
+
+	Loop(size_t count, size_t threadCount, const std::function<void(size_t)>& fn)
+	    : fn{fn}
+	    , queues(threadCount) {
+		const auto chunkCount = std::min(count, threadCount * ChunksPerThread);
+		const auto chunkSize = (count + chunkCount - 1) / chunkCount;
+		size_t queue = 0;
+		for (size_t begin = 0; begin < count; begin += chunkSize) {
+			queues[queue].chunks.push_back(Chunk{begin, std::min(count, begin + chunkSize)});
+			queue = (queue + 1) % queues.size();
+		}
+	}
+
+	//! Run chunks until every queue is empty
+	void run(size_t thread) {
+		while (const auto chunk = takeChunk(thread)) {
+			for (size_t i = chunk->begin; i < chunk->end; ++i) {
+				fn(i);
+			}
+		}
+	}
+
+	std::optional<Chunk> takeChunk(size_t thread) {
+		{
+			auto& own = queues[thread];
+			std::lock_guard<std::mutex> lock{own.mutex};
+			if (!own.chunks.empty()) {
+				const auto chunk = own.chunks.back();
+				own.chunks.pop_back();
+				return chunk;
+			}
+		}
+		for (size_t offset = 1; offset < queues.size(); ++offset) {
+			auto& other = queues[(thread + offset) % queues.size()];
+			std::lock_guard<std::mutex> lock{other.mutex};
+			if (!other.chunks.empty()) {
+				const auto chunk = other.chunks.front();
+				other.chunks.pop_front();
+				return chunk;
+			}
+		}
+		return std::nullopt;
+	}
+
+	const std::function<void(size_t)>& fn;
+	vector<Queue> queues;
+	//! Queue of the next worker to join.  Queue 0 belongs to the thread that started the loop.
+	std::atomic<size_t> nextThread{1};
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t threadCount) {
+	m_threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		m_threads.emplace_back([this] { runWorker(); });
+	}
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+	Shutdown();
+}
+
+WorkStealingThreadPool& WorkStealingThreadPool::GetShared() {
+	// Leaked on purpose, see the header
+	static auto* pool =
+	    new WorkStealingThreadPool{std::max(std::thread::hardware_concurrency(), 1u) - 1};
+	return *pool;
+}
+
+void WorkStealingThreadPool::Shutdown() {
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		if (m_stopping) {
+			return;
+		}
+		m_stopping = true;
+	}
+	m_loopStarted.notify_all();
+	for (auto& thread : m_threads) {
+		thread.join();
+	}
+}
+
+void WorkStealingThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn) {
+	auto runSerially = [&] {
+		for (size_t i = 0; i < count; ++i) {
+			fn(i);
+		}
+	};
+	if (m_threads.empty() || count < 2 || t_isInParallelFor) {
+		runSerially();
+		return;
+	}
+
+	Loop loop{count, m_threads.size() + 1, fn};
+	bool isPoolBusy = false;
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		// Another thread's loop is running, or the workers have been shut down
+		isPoolBusy = m_loop != nullptr || m_stopping;
+		if (!isPoolBusy) {
+			m_loop = &loop;
+			++m_loopNumber;
+		}
+	}
+	if (isPoolBusy) {
+		runSerially();
+		return;
+	}
+	m_loopStarted.notify_all();
+
+	t_isInParallelFor = true;
+	loop.run(0);
+	t_isInParallelFor = false;
+
+	// Every chunk has been taken, but workers may still be running theirs
+	std::unique_lock<std::mutex> lock{m_mutex};
+	m_loop = nullptr;
+	m_workerLeft.wait(lock, [this] { return m_activeWorkers == 0; });
+}
+
+void WorkStealingThreadPool::runWorker() {
+	t_isInParallelFor = true;
+	uint64_t lastLoopNumber = 0;
+	std::unique_lock<std::mutex> lock{m_mutex};
+	while (true) {
+		m_loopStarted.wait(
+		    lock, [&] { return m_stopping || (m_loop && m_loopNumber != lastLoopNumber); });
+		if (m_stopping) {
+			return;
+		}
+		lastLoopNumber = m_loopNumber;
+		auto* loop = m_loop;
+		++m_activeWorkers;
+		lock.unlock();
+
+		loop->run(loop->nextThread++);
+
+		lock.lock();
+		--m_activeWorkers;
+		m_workerLeft.notify_all();
+	}
+}
@@ -0,0 +1,83 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Glass {
+	namespace Private {
+		//! Fixed set of worker threads that run ParallelFor loops.
+		//!
+		//! Each loop is split into chunks that are dealt out to a queue per participating
+		//! thread.  A thread takes chunks from the back of its own queue, and once that is
+		//! empty steals from the front of the others', so uneven work evens out.
+		class WorkStealingThreadPool {
+		public:
+			//! `threadCount` worker threads are started; the thread calling ParallelFor also
+			//! takes part, so a pool with no workers runs loops serially.
+			explicit WorkStealingThreadPool(size_t threadCount);
+			//! Calls Shutdown
+			~WorkStealingThreadPool();
+
+			WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+			WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+			//! Pool shared by the property serialization code, with a worker for every
+			//! hardware thread but one.
+			//!
+			//! The shared pool is deliberately never destroyed: joining its workers from a
+			//! static destructor can deadlock while a DLL is being unloaded on Windows, and
+			//! races with other static destructors at exit.  Its idle workers are simply
+			//! ended with the process.  A host that unloads the library before exiting should
+			//! call Shutdown on it first.
+			static WorkStealingThreadPool& GetShared();
+
+			//! Stop and join the worker threads.  A loop that is running finishes on the
+			//! thread that started it, and later loops run serially on the calling thread.
+			//! Calling this more than once does nothing.  Must not be called from inside a
+			//! loop.
+			void Shutdown();
+
+			//! Call `fn(i)` for every i in [0, count), and return once every call has finished.
+			//! Calls may happen on any thread and in any order, and `fn` must not throw.  Loops
+			//! started from inside `fn`, or while another thread's loop is running, are run
+			//! serially on the calling thread.
+			void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+			size_t GetThreadCount() const { return m_threads.size(); }
+
+		private:
+			struct Loop;
+
+			void runWorker();
+
+			vector<std::thread> m_threads;
+
+			std::mutex m_mutex;
+			std::condition_variable m_loopStarted;
+			std::condition_variable m_workerLeft;
+			//! The running loop, if any.  Guarded by m_mutex, along with the members below.
+			Loop* m_loop = nullptr;
+			//! Incremented for every loop, so a worker joins each loop at most once
+			uint64_t m_loopNumber = 0;
+			size_t m_activeWorkers = 0;
+			bool m_stopping = false;
+		};
+	}
+}
@@ -0,0 +1,73 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include <atomic>
+
+#include "Glass/Properties/Private/ThreadPool.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+using Glass::Private::WorkStealingThreadPool;
+
+TEST(WorkStealingThreadPool, CallsEveryIndexOnce) {
+	WorkStealingThreadPool pool{4};
+	constexpr size_t Count = 10000;
+	vector<std::atomic<int>> calls(Count);
+	pool.ParallelFor(Count, [&](size_t i) { ++calls[i]; });
+	for (const auto& callCount : calls) {
+		ASSERT_EQ(1, callCount.load());
+	}
+}
+
+TEST(WorkStealingThreadPool, RunsManyLoops) {
+	WorkStealingThreadPool pool{3};
+	std::atomic<size_t> total{0};
+	size_t expected = 0;
+	for (size_t count = 0; count < 200; ++count) {
+		pool.ParallelFor(count, [&](size_t i) { total += i; });
+		expected += count * (count - (count > 0 ? 1 : 0)) / 2;
+	}
+	ASSERT_EQ(expected, total.load());
+}
+
+TEST(WorkStealingThreadPool, NoWorkersRunsOnCallingThread) {
+	WorkStealingThreadPool pool{0};
+	ASSERT_EQ(0u, pool.GetThreadCount());
+	const auto caller = std::this_thread::get_id();
+	bool ranOnCaller = true;
+	pool.ParallelFor(100, [&](size_t) { ranOnCaller &= std::this_thread::get_id() == caller; });
+	ASSERT_TRUE(ranOnCaller);
+}
+
+TEST(WorkStealingThreadPool, NestedLoops) {
+	WorkStealingThreadPool pool{4};
+	std::atomic<size_t> calls{0};
+	pool.ParallelFor(16, [&](size_t) { pool.ParallelFor(16, [&](size_t) { ++calls; }); });
+	ASSERT_EQ(16u * 16u, calls.load());
+}
+
+TEST(WorkStealingThreadPool, ShutdownRunsLoopsOnCallingThread) {
+	WorkStealingThreadPool pool{4};
+	pool.Shutdown();
+	pool.Shutdown();
+	const auto caller = std::this_thread::get_id();
+	bool ranOnCaller = true;
+	pool.ParallelFor(100, [&](size_t) { ranOnCaller &= std::this_thread::get_id() == caller; });
+	ASSERT_TRUE(ranOnCaller);
+}
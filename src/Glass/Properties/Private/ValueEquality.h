@@ -0,0 +1,70 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "Glass/Properties/Types/Meta.h"
+
+namespace Glass {
+	namespace Private {
+		//! Whether values of V are equal exactly when their bytes are, so they can be compared
+		//! with memcmp.  Types with their own operator== are only compared bitwise if they are
+		//! scalars, since a class's operator== may ignore some of its members.
+		template <typename V>
+		constexpr bool IsBitwiseComparable_v =
+		    std::has_unique_object_representations_v<V> &&
+		    (std::is_scalar_v<V> || !IsEqualityComparable_v<V>);
+
+		template <typename V> struct CanCompareValues {
+			static constexpr bool value = IsBitwiseComparable_v<V> || IsEqualityComparable_v<V>;
+		};
+
+		template <typename T, typename A> struct CanCompareValues<std::vector<T, A>> {
+			static constexpr bool value = IsBitwiseComparable_v<T> || IsEqualityComparable_v<T>;
+		};
+
+		//! True if areValuesEqual can compare values of V
+		template <typename V> constexpr bool CanCompareValues_v = CanCompareValues<V>::value;
+
+		//! Compare two values of a property type.  Bitwise comparable values, and vectors of
+		//! them, are compared with a single memcmp; everything else uses operator==.
+		template <typename V> bool areValuesEqual(const V& lhs, const V& rhs) {
+			static_assert(CanCompareValues_v<V>, "V can't be compared");
+			if constexpr (IsBitwiseComparable_v<V>) {
+				return std::memcmp(&lhs, &rhs, sizeof(V)) == 0;
+			} else {
+				return lhs == rhs;
+			}
+		}
+
+		template <typename T, typename A>
+		bool areValuesEqual(const std::vector<T, A>& lhs, const std::vector<T, A>& rhs) {
+			static_assert(CanCompareValues_v<T>, "T can't be compared");
+			// vector<bool> packs its elements into bits, and has no data()
+			if constexpr (IsBitwiseComparable_v<T> && !std::is_same_v<T, bool>) {
+				return lhs.size() == rhs.size() &&
+				       (lhs.empty() ||
+				        std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0);
+			} else {
+				return lhs == rhs;
+			}
+		}
+	}
+}
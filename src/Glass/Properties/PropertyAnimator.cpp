@@ -0,0 +1,129 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/PropertyAnimator.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+using Glass::PropertyAnimator;
+
+float Glass::Ease(Easing easing, float t) {
+	switch (easing) {
+	case Easing::Linear:
+		return t;
+	case Easing::EaseIn:
+		return t * t * t;
+	case Easing::EaseOut: {
+		const auto remaining = 1.f - t;
+		return 1.f - remaining * remaining * remaining;
+	}
+	case Easing::EaseInOut:
+		return t * t * (3.f - 2.f * t);
+	}
+	return t;
+}
+
+bool PropertyAnimator::Cancel(AnimationId id) {
+	ZASSERT(!m_isStepping);
+	const auto count = m_animations.size();
+	removeAnimations([&](const Animation& animation) { return animation.id == id; });
+	return m_animations.size() != count;
+}
+
+void PropertyAnimator::CancelAll(HasPropertiesBase& object) {
+	ZASSERT(!m_isStepping);
+	const auto* holder = &getHolder(object);
+	removeAnimations([&](const Animation& animation) { return animation.holder == holder; });
+}
+
+void PropertyAnimator::Step(float deltaTime) {
+	ZASSERT(!m_isStepping);
+	m_isStepping = true;
+
+	const auto componentCount = m_fromComponents.size();
+	m_progress.resize(componentCount);
+	m_components.resize(componentCount);
+	bool hasFinished = false;
+	for (size_t i = 0; i < m_animations.size(); ++i) {
+		m_elapsed[i] += deltaTime;
+		const auto t = m_durations[i] > 0.f ? std::min(m_elapsed[i] / m_durations[i], 1.f) : 1.f;
+		auto& animation = m_animations[i];
+		animation.isFinished = t >= 1.f;
+		hasFinished |= animation.isFinished;
+		std::fill_n(m_progress.begin() + animation.componentOffset,
+		            animation.componentCount,
+		            Ease(m_easings[i], t));
+	}
+
+	const auto* from = m_fromComponents.data();
+	const auto* to = m_toComponents.data();
+	const auto* progress = m_progress.data();
+	auto* components = m_components.data();
+	for (size_t i = 0; i < componentCount; ++i) {
+		components[i] = from[i] + (to[i] - from[i]) * progress[i];
+	}
+
+	// Group the animations by object, so each object's handlers see all of its new values
+	const auto animationCount = m_animations.size();
+	m_applyOrder.resize(animationCount);
+	std::iota(m_applyOrder.begin(), m_applyOrder.end(), size_t{0});
+	std::stable_sort(m_applyOrder.begin(), m_applyOrder.end(), [&](size_t lhs, size_t rhs) {
+		return std::less<const SimplePropertyHolder*>{}(m_animations[lhs].holder,
+		                                                m_animations[rhs].holder);
+	});
+	for (size_t begin = 0; begin < animationCount;) {
+		auto* holder = m_animations[m_applyOrder[begin]].holder;
+		m_assignedIndices.clear();
+		auto end = begin;
+		for (; end < animationCount && m_animations[m_applyOrder[end]].holder == holder; ++end) {
+			const auto& animation = m_animations[m_applyOrder[end]];
+			// Finished animations land exactly on their targets, whatever the rounding
+			const auto& source = animation.isFinished ? m_toComponents : m_components;
+			if (animation.apply(*holder,
+			                    animation.index,
+			                    gsl::span<const float>{source}.subspan(animation.componentOffset,
+			                                                           animation.componentCount),
+			                    animation.from,
+			                    animation.to)) {
+				m_assignedIndices.push_back(animation.index);
+			}
+		}
+		for (const auto index : m_assignedIndices) {
+			holder->FirePropertySignal(index);
+		}
+		begin = end;
+	}
+	m_isStepping = false;
+
+	if (hasFinished) {
+		removeAnimations([](const Animation& animation) { return animation.isFinished; });
+	}
+}
+
+PropertyAnimator::AnimationId
+PropertyAnimator::addAnimation(Animation animation, float duration, Easing easing) {
+	animation.id = m_nextId++;
+	const auto id = animation.id;
+	m_animations.push_back(std::move(animation));
+	m_elapsed.push_back(0.f);
+	m_durations.push_back(duration);
+	m_easings.push_back(easing);
+	return id;
+}
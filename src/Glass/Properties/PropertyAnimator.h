@@ -0,0 +1,229 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "gsl/span"
+
+#include "Glass/Properties/HasPropertiesBase.h"
+#include "Glass/Properties/PropertyDefinition.h"
+#include "Glass/Properties/Private/ValueEquality.h"
+#include "Glass/Properties/Private/getName.h"
+#include "Glass/Properties/Types/Meta.h"
+
+namespace Glass {
+	//! How an animation's progress is mapped from elapsed time
+	enum class Easing : uint8_t {
+		Linear,
+		EaseIn,
+		EaseOut,
+		EaseInOut,
+	};
+
+	//! The eased progress at `t` in [0, 1]
+	float Ease(Easing easing, float t);
+
+	//! Animates properties of any number of objects from their current values to target
+	//! values, for property types that can be interpolated (see PropertyType).
+	//!
+	//! Each frame, Step advances every active animation in one pass over packed arrays of
+	//! times and interpolation components, then updates each animated object in one go: all of
+	//! its animated properties are set before any of their signals fire.  Properties whose
+	//! values didn't change that frame aren't set, so they don't fire signals.  Animated values
+	//! are assigned with SimplePropertyHolder::AssignPropertyAt without recording an edit, so
+	//! they aren't recorded in an undo history.  Computed properties can't be animated.
+	//!
+	//! Animated objects must outlive their animations, or cancel them with CancelAll.
+	class PropertyAnimator {
+	public:
+		using AnimationId = uint64_t;
+
+		//! Animate P of `object` from its current value to `target` over `duration` seconds.
+		//! An animation of the same property that is already running is cancelled, so the new
+		//! one starts from wherever that one got to.
+		template <typename P>
+		AnimationId Animate(HasPropertiesBase& object,
+		                    typename P::property_type::type target,
+		                    float duration,
+		                    Easing easing = Easing::EaseInOut);
+
+		//! Stop an animation, leaving its property at its current value.  Returns false if
+		//! the animation has already finished or been cancelled.
+		bool Cancel(AnimationId id);
+
+		//! Stop all animations of `object`'s properties
+		void CancelAll(HasPropertiesBase& object);
+
+		//! Advance every animation by `deltaTime` seconds and set the animated properties.
+		//! Animations that reach their end set their target values and are removed.  Signal
+		//! handlers of the animated properties must not start or cancel animations.
+		void Step(float deltaTime);
+
+		size_t GetAnimationCount() const { return m_animations.size(); }
+
+	private:
+		//! Assign a property the value of its type described by the components, without firing
+		//! its signal.  Returns whether the property was assigned.
+		using ApplyFn = bool (*)(SimplePropertyHolder& holder,
+		                         size_t index,
+		                         gsl::span<const float> components,
+		                         const boost::any& from,
+		                         const boost::any& to);
+
+		struct Animation {
+			AnimationId id;
+			SimplePropertyHolder* holder;
+			size_t index;
+			ApplyFn apply;
+			boost::any from;
+			boost::any to;
+			size_t componentOffset;
+			size_t componentCount;
+			bool isFinished;
+		};
+
+		template <typename T>
+		static bool applyComponents(SimplePropertyHolder& holder,
+		                            size_t index,
+		                            gsl::span<const float> components,
+		                            const boost::any& from,
+		                            const boost::any& to);
+
+		static SimplePropertyHolder& getHolder(HasPropertiesBase& object) {
+			return *object.m_propertyHolder;
+		}
+
+		//! Add an animation whose start and end values have been written to the end of
+		//! m_fromComponents and m_toComponents
+		AnimationId addAnimation(Animation animation, float duration, Easing easing);
+
+		//! Remove the animations for which `shouldRemove` is true, keeping the others in order
+		template <typename F> void removeAnimations(F&& shouldRemove);
+
+		//! Indexed like m_animations
+		vector<Animation> m_animations;
+		vector<float> m_elapsed;
+		vector<float> m_durations;
+		vector<Easing> m_easings;
+
+		//! The components of every animation, one after another.  m_progress holds the eased
+		//! progress of each component's animation, so blending is a single loop.
+		vector<float> m_fromComponents;
+		vector<float> m_toComponents;
+		vector<float> m_progress;
+		vector<float> m_components;
+
+		//! Step's scratch: animations in the order they're applied, grouped by holder, and the
+		//! properties of the current holder that were assigned
+		vector<size_t> m_applyOrder;
+		vector<size_t> m_assignedIndices;
+
+		AnimationId m_nextId = 1;
+		bool m_isStepping = false;
+	};
+
+	template <typename P>
+	PropertyAnimator::AnimationId PropertyAnimator::Animate(HasPropertiesBase& object,
+	                                                       typename P::property_type::type target,
+	                                                       float duration,
+	                                                       Easing easing) {
+		using T = typename P::property_type;
+		using Value = typename T::type;
+		static_assert(!Meta::IsComputedProperty<P>, "Computed properties can't be animated");
+		static_assert(HasInterpolation_v<T>, "P's type can't be interpolated");
+		constexpr size_t ComponentCount = T::interpolationComponentCount;
+
+		ZASSERT(!m_isStepping);
+		auto& holder = getHolder(object);
+		const auto index = holder.FindPropertyIndex(Private::getName<P>());
+		ZASSERT(index);
+		const auto* current = holder.GetPropertyPointerAt<Value>(*index);
+		ZASSERT(current);
+
+		removeAnimations([&](const Animation& animation) {
+			return animation.holder == &holder && animation.index == *index;
+		});
+		const auto offset = m_fromComponents.size();
+		m_fromComponents.resize(offset + ComponentCount);
+		m_toComponents.resize(offset + ComponentCount);
+		T::toComponents(*current,
+		                gsl::span<float>{m_fromComponents}.subspan(offset, ComponentCount));
+		T::toComponents(target, gsl::span<float>{m_toComponents}.subspan(offset, ComponentCount));
+		return addAnimation(Animation{0,
+		                              &holder,
+		                              *index,
+		                              &applyComponents<T>,
+		                              boost::any{*current},
+		                              boost::any{std::move(target)},
+		                              offset,
+		                              ComponentCount,
+		                              false},
+		                    duration,
+		                    easing);
+	}
+
+	template <typename T>
+	bool PropertyAnimator::applyComponents(SimplePropertyHolder& holder,
+	                                       size_t index,
+	                                       gsl::span<const float> components,
+	                                       const boost::any& from,
+	                                       const boost::any& to) {
+		using Value = typename T::type;
+		auto value = T::fromComponents(
+		    components, *boost::any_cast<Value>(&from), *boost::any_cast<Value>(&to));
+		if constexpr (Private::CanCompareValues_v<Value>) {
+			const auto* current = holder.template GetPropertyPointerAt<Value>(index);
+			if (current && Private::areValuesEqual(*current, value)) {
+				return false;
+			}
+		}
+		return holder.AssignPropertyAt(index, std::move(value), false);
+	}
+
+	template <typename F> void PropertyAnimator::removeAnimations(F&& shouldRemove) {
+		size_t kept = 0;
+		size_t keptComponents = 0;
+		for (size_t i = 0; i < m_animations.size(); ++i) {
+			auto& animation = m_animations[i];
+			if (shouldRemove(static_cast<const Animation&>(animation))) {
+				continue;
+			}
+			std::copy_n(m_fromComponents.begin() + animation.componentOffset,
+			            animation.componentCount,
+			            m_fromComponents.begin() + keptComponents);
+			std::copy_n(m_toComponents.begin() + animation.componentOffset,
+			            animation.componentCount,
+			            m_toComponents.begin() + keptComponents);
+			animation.componentOffset = keptComponents;
+			keptComponents += animation.componentCount;
+			if (kept != i) {
+				m_animations[kept] = std::move(animation);
+				m_elapsed[kept] = m_elapsed[i];
+				m_durations[kept] = m_durations[i];
+				m_easings[kept] = m_easings[i];
+			}
+			++kept;
+		}
+		m_animations.resize(kept);
+		m_elapsed.resize(kept);
+		m_durations.resize(kept);
+		m_easings.resize(kept);
+		m_fromComponents.resize(keptComponents);
+		m_toComponents.resize(keptComponents);
+	}
+}
@@ -0,0 +1,165 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/HasProperties.h"
+#include "Glass/Properties/HasPropertiesBase.h"
+#include "Glass/Properties/PropertyAnimator.h"
+#include "Glass/Properties/Types/Builtins.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+namespace {
+	using Glass::Easing;
+	using Glass::PropertyAnimator;
+
+	struct Opacity : Glass::PropertyDefinition<Opacity, Glass::FloatPropertyType> {
+		static constexpr const char* const name = "Opacity";
+		static constexpr float defaultValue = 0.f;
+	};
+
+	struct Padding : Glass::PropertyDefinition<Padding, Glass::Float4DimPropertyType> {
+		static constexpr const char* const name = "Padding";
+		static Glass::Float4Dim defaultValue() { return Glass::Float4Dim{0.f}; }
+	};
+
+	struct Widget : public Glass::HasPropertiesBase,
+	                public Glass::HasProperties<Widget, Glass::PropertyList<Opacity, Padding>> {
+		void didSet(Opacity) {
+			++opacitySetCount;
+			paddingAtOpacityDidSet = GetProperty<Padding>();
+		}
+
+		size_t opacitySetCount = 0;
+		Glass::Float4Dim paddingAtOpacityDidSet;
+	};
+}
+
+TEST(PropertyAnimator, Ease) {
+	for (const auto easing :
+	     {Easing::Linear, Easing::EaseIn, Easing::EaseOut, Easing::EaseInOut}) {
+		ASSERT_EQ(0.f, Glass::Ease(easing, 0.f));
+		ASSERT_EQ(1.f, Glass::Ease(easing, 1.f));
+	}
+	ASSERT_EQ(.5f, Glass::Ease(Easing::EaseInOut, .5f));
+	ASSERT_LT(Glass::Ease(Easing::EaseIn, .5f), .5f);
+	ASSERT_GT(Glass::Ease(Easing::EaseOut, .5f), .5f);
+}
+
+TEST(PropertyAnimator, StepAnimatesToTarget) {
+	Widget widget;
+	PropertyAnimator animator;
+	animator.Animate<Opacity>(widget, 1.f, 1.f, Easing::Linear);
+	animator.Animate<Padding>(
+	    widget, Glass::Float4Dim{std::array<float, 4>{4.f, 8.f, 0.f, 0.f}}, 2.f, Easing::Linear);
+	ASSERT_EQ(2u, animator.GetAnimationCount());
+	ASSERT_EQ(0u, widget.opacitySetCount);
+
+	animator.Step(.5f);
+	ASSERT_EQ(.5f, widget.GetProperty<Opacity>());
+	ASSERT_TRUE((Glass::Float4Dim{std::array<float, 4>{1.f, 2.f, 0.f, 0.f}} ==
+	             widget.GetProperty<Padding>()));
+	ASSERT_EQ(1u, widget.opacitySetCount);
+
+	animator.Step(.5f);
+	ASSERT_EQ(1.f, widget.GetProperty<Opacity>());
+	ASSERT_EQ(1u, animator.GetAnimationCount());
+
+	// Finished animations don't set their properties again
+	animator.Step(1.5f);
+	ASSERT_TRUE((Glass::Float4Dim{std::array<float, 4>{4.f, 8.f, 0.f, 0.f}} ==
+	             widget.GetProperty<Padding>()));
+	ASSERT_EQ(0u, animator.GetAnimationCount());
+	ASSERT_EQ(2u, widget.opacitySetCount);
+}
+
+TEST(PropertyAnimator, UnchangedValuesArentSet) {
+	Widget widget;
+	PropertyAnimator animator;
+	animator.Animate<Opacity>(widget, 0.f, 1.f);
+	animator.Step(.5f);
+	animator.Step(.5f);
+	ASSERT_EQ(0u, widget.opacitySetCount);
+	ASSERT_EQ(0u, animator.GetAnimationCount());
+}
+
+TEST(PropertyAnimator, AnimatingAgainRestartsFromCurrentValue) {
+	Widget widget;
+	PropertyAnimator animator;
+	animator.Animate<Opacity>(widget, 1.f, 1.f, Easing::Linear);
+	animator.Step(.5f);
+	animator.Animate<Opacity>(widget, 0.f, 1.f, Easing::Linear);
+	ASSERT_EQ(1u, animator.GetAnimationCount());
+	animator.Step(.5f);
+	ASSERT_EQ(.25f, widget.GetProperty<Opacity>());
+}
+
+TEST(PropertyAnimator, Cancel) {
+	Widget first;
+	Widget second;
+	PropertyAnimator animator;
+	const auto id = animator.Animate<Opacity>(first, 1.f, 1.f, Easing::Linear);
+	animator.Animate<Padding>(first, Glass::Float4Dim{1.f}, 1.f, Easing::Linear);
+	animator.Animate<Opacity>(second, 1.f, 1.f, Easing::Linear);
+	animator.Step(.25f);
+
+	ASSERT_TRUE(animator.Cancel(id));
+	ASSERT_FALSE(animator.Cancel(id));
+	animator.Step(.25f);
+	ASSERT_EQ(.25f, first.GetProperty<Opacity>());
+	ASSERT_TRUE(Glass::Float4Dim{.5f} == first.GetProperty<Padding>());
+	ASSERT_EQ(.5f, second.GetProperty<Opacity>());
+
+	animator.CancelAll(first);
+	ASSERT_EQ(1u, animator.GetAnimationCount());
+	animator.Step(.5f);
+	ASSERT_TRUE(Glass::Float4Dim{.5f} == first.GetProperty<Padding>());
+	ASSERT_EQ(1.f, second.GetProperty<Opacity>());
+}
+
+TEST(PropertyAnimator, ObjectsAreUpdatedTogether) {
+	Widget first;
+	Widget second;
+	PropertyAnimator animator;
+	// Interleave the animations of the two objects
+	animator.Animate<Opacity>(first, 1.f, 1.f, Easing::Linear);
+	animator.Animate<Opacity>(second, 1.f, 1.f, Easing::Linear);
+	animator.Animate<Padding>(first, Glass::Float4Dim{4.f}, 1.f, Easing::Linear);
+	animator.Step(.5f);
+	// Padding comes after Opacity, but was already set when Opacity's didSet was called
+	ASSERT_TRUE(Glass::Float4Dim{2.f} == first.paddingAtOpacityDidSet);
+	ASSERT_EQ(1u, first.opacitySetCount);
+	ASSERT_EQ(1u, second.opacitySetCount);
+}
+
+TEST(PropertyAnimator, StepsArentRecordedInUndoHistory) {
+	Glass::PropertyUndoHistory history;
+	Widget first;
+	Widget second;
+	first.SetUndoHistory(&history);
+	second.SetUndoHistory(&history);
+	PropertyAnimator animator;
+	animator.Animate<Opacity>(first, 1.f, 1.f, Easing::Linear);
+	animator.Animate<Opacity>(second, 1.f, 1.f, Easing::Linear);
+	for (int i = 0; i < 4; ++i) {
+		animator.Step(.25f);
+	}
+	ASSERT_EQ(1.f, first.GetProperty<Opacity>());
+	ASSERT_EQ(0u, history.GetUndoCount());
+}
@@ -0,0 +1,374 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/PropertyJournal.h"
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <unordered_map>
+
+#include "Glass/Properties/Private/MappedFile.h"
+#include "Glass/Properties/Private/ReplaceFile.h"
+#include "Glass/Properties/SimplePropertyHolder.h"
+
+// Property journal format:
+//   char[4]  magic
+//   uint32_t PropertyJournalVersion
+//   batches, one per Flush, each:
+//     uint32_t payload size
+//     uint32_t CRC-32 of the payload
+//     payload: records, each:
+//       uint64_t object id, length prefixed property name, length prefixed value
+
+using Glass::PropertyJournal;
+
+namespace {
+	using Magic = std::array<char, 4>;
+	constexpr Magic PropertyJournalMagic{{'G', 'P', 'J', 'F'}};
+	//! Version of the journal file format.  Bump this when the format changes.
+	constexpr uint32_t PropertyJournalVersion = 2;
+
+	constexpr std::array<uint32_t, 256> makeCrcTable() {
+		std::array<uint32_t, 256> table{};
+		for (uint32_t i = 0; i < table.size(); ++i) {
+			auto crc = i;
+			for (int bit = 0; bit < 8; ++bit) {
+				crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320u : crc >> 1;
+			}
+			table[i] = crc;
+		}
+		return table;
+	}
+	constexpr auto CrcTable = makeCrcTable();
+
+	//! CRC-32 (IEEE 802.3)
+	uint32_t crc32(const uint8_t* data, size_t size) {
+		uint32_t crc = ~0u;
+		for (size_t i = 0; i < size; ++i) {
+			crc = CrcTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+		}
+		return ~crc;
+	}
+
+	struct JournalRecord {
+		uint64_t objectId;
+		std::string_view name;
+		std::string_view value;
+	};
+
+	struct RecordKey {
+		uint64_t objectId;
+		std::string_view name;
+
+		bool operator==(const RecordKey& other) const {
+			return objectId == other.objectId && name == other.name;
+		}
+	};
+
+	struct RecordKeyHash {
+		size_t operator()(const RecordKey& key) const {
+			return std::hash<std::string_view>{}(key.name) ^
+			       static_cast<size_t>(key.objectId * 0x9e3779b97f4a7c15ull);
+		}
+	};
+
+	void writeHeader(Glass::BinaryWriter& writer) {
+		writer.Write(PropertyJournalMagic);
+		writer.Write(PropertyJournalVersion);
+	}
+
+	void writeRecord(Glass::BinaryWriter& writer, const JournalRecord& record) {
+		writer.Write(record.objectId);
+		writer.WriteString(record.name);
+		writer.WriteString(record.value);
+	}
+
+	//! Frame the records in `records` as a batch
+	void writeBatch(Glass::BinaryWriter& writer, const vector<uint8_t>& records) {
+		writer.WriteSize(records.size());
+		writer.Write(crc32(records.data(), records.size()));
+		writer.WriteBytes(records.data(), records.size());
+	}
+
+	//! Call `fn` with each record of the journal in `data`, in order, stopping at the first
+	//! corrupt or truncated batch.  A batch's records are only given to `fn` once the whole
+	//! batch has been read, so a batch is either applied entirely or not at all.  Returns the
+	//! size of the valid part of the journal, or std::nullopt if it doesn't start with a
+	//! journal header.
+	template <typename F>
+	std::optional<size_t> readRecords(const uint8_t* data, size_t size, F&& fn) {
+		Glass::BinaryReader reader{data, size};
+		const auto magic = reader.Read<Magic>();
+		const auto version = reader.Read<uint32_t>();
+		if (!magic || *magic != PropertyJournalMagic || !version ||
+		    *version != PropertyJournalVersion) {
+			return std::nullopt;
+		}
+
+		auto validSize = size - reader.GetRemaining();
+		vector<JournalRecord> batch;
+		while (!reader.IsAtEnd()) {
+			const auto payloadSize = reader.ReadSize();
+			const auto checksum = reader.Read<uint32_t>();
+			if (!payloadSize || !checksum) {
+				break;
+			}
+			const auto* payloadData = data + (size - reader.GetRemaining());
+			auto payload = reader.ReadSubReader(*payloadSize);
+			if (!payload || crc32(payloadData, *payloadSize) != *checksum) {
+				break;
+			}
+			batch.clear();
+			bool isValid = true;
+			while (!payload->IsAtEnd()) {
+				const auto objectId = payload->Read<uint64_t>();
+				const auto name = payload->ReadStringView();
+				const auto value = payload->ReadStringView();
+				if (!objectId || !name || !value) {
+					isValid = false;
+					break;
+				}
+				batch.push_back(JournalRecord{*objectId, *name, *value});
+			}
+			if (!isValid) {
+				break;
+			}
+			for (const auto& record : batch) {
+				fn(record);
+			}
+			validSize = size - reader.GetRemaining();
+		}
+		return validSize;
+	}
+
+	//! The latest record of each property in the first `size` bytes of `data`, in the order
+	//! each property was first recorded.  Returns std::nullopt if `data` isn't a journal.
+	std::optional<vector<JournalRecord>> readLatestRecords(const uint8_t* data, size_t size) {
+		vector<JournalRecord> records;
+		std::unordered_map<RecordKey, size_t, RecordKeyHash> positions;
+		const auto validSize = readRecords(data, size, [&](const JournalRecord& record) {
+			const auto [it, isNew] =
+			    positions.try_emplace(RecordKey{record.objectId, record.name}, records.size());
+			if (isNew) {
+				records.push_back(record);
+			} else {
+				records[it->second].value = record.value;
+			}
+		});
+		if (!validSize) {
+			return std::nullopt;
+		}
+		return records;
+	}
+
+	bool writeFile(const std::string& path, const vector<uint8_t>& bytes, std::ios::openmode mode) {
+		std::ofstream file{path, std::ios::binary | mode};
+		file.write(reinterpret_cast<const char*>(bytes.data()),
+		           static_cast<std::streamsize>(bytes.size()));
+		return static_cast<bool>(file);
+	}
+
+}
+
+PropertyJournal::PropertyJournal(std::string path)
+    : m_path{std::move(path)} {
+	std::error_code error;
+	const auto fileSize = std::filesystem::file_size(m_path, error);
+	if (error || fileSize == 0) {
+		BinaryWriter header;
+		writeHeader(header);
+		if (!writeFile(m_path, header.GetBuffer(), std::ios::trunc)) {
+			return;
+		}
+		m_size = header.GetSize();
+	} else {
+		std::optional<size_t> validSize;
+		if (const auto file = Private::MappedFile::Open(m_path)) {
+			validSize = readRecords(file->GetData(), file->GetSize(), [](const JournalRecord&) {});
+		}
+		if (!validSize) {
+			// Leave files that aren't journals alone
+			return;
+		}
+		// Drop a batch torn by a crash, or new batches would be appended after it and never
+		// be replayed
+		if (*validSize != fileSize) {
+			std::filesystem::resize_file(m_path, *validSize, error);
+			if (error) {
+				return;
+			}
+		}
+		m_size = *validSize;
+	}
+	m_file.open(m_path, std::ios::binary | std::ios::app);
+}
+
+PropertyJournal::~PropertyJournal() {
+	Flush();
+	WaitForCompaction();
+}
+
+bool PropertyJournal::IsOpen() const {
+	std::lock_guard<std::mutex> lock{m_fileMutex};
+	return m_file.is_open();
+}
+
+void PropertyJournal::Record(uint64_t objectId,
+                             std::string_view name,
+                             std::string_view serializedValue) {
+	writeRecord(m_pending, JournalRecord{objectId, name, serializedValue});
+}
+
+bool PropertyJournal::Record(uint64_t objectId,
+                             const SimplePropertyHolder& holder,
+                             std::string_view name) {
+	const auto serialized = holder.SerializeProperty(name);
+	if (!serialized) {
+		return false;
+	}
+	Record(objectId, name, *serialized);
+	return true;
+}
+
+bool PropertyJournal::Flush() {
+	if (m_pending.GetSize() == 0) {
+		return true;
+	}
+	BinaryWriter framed;
+	writeBatch(framed, m_pending.GetBuffer());
+	m_pending = BinaryWriter{};
+	const auto& batch = framed.GetBuffer();
+
+	std::lock_guard<std::mutex> lock{m_fileMutex};
+	if (!m_file.is_open()) {
+		return false;
+	}
+	m_file.write(reinterpret_cast<const char*>(batch.data()),
+	             static_cast<std::streamsize>(batch.size()));
+	m_file.flush();
+	if (!m_file || !Private::syncFile(m_path)) {
+		// Cut off whatever part of the batch was written, so later batches can be replayed
+		m_file.close();
+		std::error_code error;
+		std::filesystem::resize_file(m_path, m_size, error);
+		m_file.open(m_path, std::ios::binary | std::ios::app);
+		return false;
+	}
+	m_size += batch.size();
+	return true;
+}
+
+bool PropertyJournal::StartCompaction() {
+	size_t compactedSize = 0;
+	{
+		std::lock_guard<std::mutex> lock{m_fileMutex};
+		if (!m_file.is_open() || m_isCompacting) {
+			return false;
+		}
+		m_isCompacting = true;
+		compactedSize = m_size;
+	}
+	// The previous compactor has finished, but hasn't been joined
+	if (m_compactor.joinable()) {
+		m_compactor.join();
+	}
+	m_compactor = std::thread{[this, compactedSize] { compact(compactedSize); }};
+	return true;
+}
+
+bool PropertyJournal::WaitForCompaction() {
+	if (m_compactor.joinable()) {
+		m_compactor.join();
+	}
+	std::lock_guard<std::mutex> lock{m_fileMutex};
+	return m_didCompactionSucceed;
+}
+
+void PropertyJournal::compact(size_t compactedSize) {
+	// Fold the journal as it was when compaction started into a temporary file.  Flush keeps
+	// appending to the journal meanwhile, which doesn't disturb the part being read.
+	const auto temporaryPath = m_path + ".compact";
+	BinaryWriter writer;
+	writeHeader(writer);
+	bool isFolded = false;
+	if (const auto file = Private::MappedFile::Open(m_path)) {
+		if (file->GetSize() >= compactedSize) {
+			if (const auto records = readLatestRecords(file->GetData(), compactedSize)) {
+				BinaryWriter folded;
+				for (const auto& record : *records) {
+					writeRecord(folded, record);
+				}
+				if (!records->empty()) {
+					writeBatch(writer, folded.GetBuffer());
+				}
+				isFolded = writeFile(temporaryPath, writer.GetBuffer(), std::ios::trunc);
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> lock{m_fileMutex};
+	bool didSucceed = false;
+	if (isFolded) {
+		// Carry over the batches flushed since compaction started, then replace the journal
+		m_file.close();
+		vector<uint8_t> tail(m_size - compactedSize);
+		std::ifstream journal{m_path, std::ios::binary};
+		journal.seekg(static_cast<std::streamoff>(compactedSize));
+		journal.read(reinterpret_cast<char*>(tail.data()),
+		             static_cast<std::streamsize>(tail.size()));
+		const bool didReadTail = static_cast<bool>(journal);
+		journal.close();
+		// The compacted journal must be on disk before it replaces the old one, or a power loss
+		// could leave an empty or truncated journal in its place
+		didSucceed = didReadTail && writeFile(temporaryPath, tail, std::ios::app) &&
+		             Private::syncFile(temporaryPath) &&
+		             Private::replaceFile(temporaryPath, m_path);
+		if (didSucceed) {
+			m_size = writer.GetSize() + tail.size();
+		}
+		m_file.open(m_path, std::ios::binary | std::ios::app);
+	}
+	if (!didSucceed) {
+		std::remove(temporaryPath.c_str());
+	}
+	m_didCompactionSucceed = didSucceed;
+	m_isCompacting = false;
+}
+
+bool Glass::ReplayPropertyJournal(
+    const std::string& path,
+    const std::function<SimplePropertyHolder*(uint64_t objectId)>& findHolder) {
+	const auto file = Private::MappedFile::Open(path);
+	if (!file) {
+		return false;
+	}
+	const auto records = readLatestRecords(file->GetData(), file->GetSize());
+	if (!records) {
+		return false;
+	}
+	std::string value;
+	for (const auto& record : *records) {
+		if (auto* holder = findHolder(record.objectId)) {
+			value.assign(record.value);
+			holder->DeserializeProperty(record.name, value);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,115 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "Glass/Properties/Types/BinaryCodec.h"
+
+namespace Glass {
+	class SimplePropertyHolder;
+
+	//! Append-only journal of property changes, for crash safe persistence of UI and session
+	//! state without rewriting a whole document on every change.
+	//!
+	//! Each record is an (object id, property name, serialized value) triple, with values
+	//! produced by the globally registered serializers.  Records are batched in memory and
+	//! written by Flush as a single batch with a single write, so a typical use is to record
+	//! changes as they happen and flush once per frame, or less often when syncing the file to
+	//! disk on every flush is too slow for the device.  Every batch carries its length and a
+	//! checksum, so a batch torn by a crash is detected and ignored as a whole by
+	//! ReplayPropertyJournal, along with anything after it; a frame is never half applied.
+	//!
+	//! The journal only grows, so it is periodically folded into a fresh file holding just the
+	//! latest record of each property.  StartCompaction does this on a background thread while
+	//! recording and flushing carry on; batches flushed in the meantime are carried over to the
+	//! new file, which is synced to disk before it atomically replaces the journal.
+	//!
+	//! Object ids are chosen by the caller, and need only be stable between the run that wrote
+	//! the journal and the run that replays it.  Record and Flush must be called from one
+	//! thread at a time.
+	class PropertyJournal {
+	public:
+		//! Open the journal at `path` for appending, creating it if it doesn't exist.  Check
+		//! IsOpen before use.
+		explicit PropertyJournal(std::string path);
+		//! Flushes pending records and waits for any compaction to finish
+		~PropertyJournal();
+
+		PropertyJournal(const PropertyJournal&) = delete;
+		PropertyJournal& operator=(const PropertyJournal&) = delete;
+
+		//! False if the journal couldn't be opened or created, or isn't a journal
+		bool IsOpen() const;
+
+		//! Add a record to the pending batch
+		void Record(uint64_t objectId, std::string_view name, std::string_view serializedValue);
+
+		//! Serialize the property `name` of `holder` with its registered type, and add it to the
+		//! pending batch.  Returns false, recording nothing, if the property doesn't exist or
+		//! fails to serialize.
+		bool Record(uint64_t objectId, const SimplePropertyHolder& holder, std::string_view name);
+
+		//! Append the pending batch to the journal with a single write, and sync the journal to
+		//! disk so the batch survives a power loss.  Returns false if the write or the sync
+		//! failed, in which case the batch is dropped.
+		bool Flush();
+
+		//! Number of bytes of records waiting for Flush
+		size_t GetPendingSize() const { return m_pending.GetSize(); }
+
+		//! Start folding the journal into a fresh file on a background thread.  Returns false if
+		//! a compaction is already running or the journal isn't open.
+		bool StartCompaction();
+
+		//! Wait for the running compaction, if any.  Returns false if the last compaction
+		//! failed, in which case the journal is left as it was.
+		bool WaitForCompaction();
+
+	private:
+		void compact(size_t compactedSize);
+
+		const std::string m_path;
+		BinaryWriter m_pending;
+
+		//! Guards the members below, which the compactor replaces when it finishes
+		mutable std::mutex m_fileMutex;
+		std::ofstream m_file;
+		//! Size of the journal file, including every flushed batch
+		size_t m_size = 0;
+		bool m_isCompacting = false;
+		bool m_didCompactionSucceed = true;
+
+		std::thread m_compactor;
+	};
+
+	//! Apply the journal at `path` to the holders returned by `findHolder`, which returns
+	//! nullptr for objects that no longer exist.  Only the latest record of each property is
+	//! deserialized, and records for unknown objects or properties, or that fail to
+	//! deserialize, are skipped.  Replay stops at the first corrupt or truncated batch, which
+	//! is what a crash during Flush leaves behind, and none of that batch's records are
+	//! applied.  Returns false if the file is missing or
+	//! isn't a journal.
+	bool ReplayPropertyJournal(
+	    const std::string& path,
+	    const std::function<SimplePropertyHolder*(uint64_t objectId)>& findHolder);
+}
@@ -0,0 +1,205 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+
+#include "Glass/Properties/PropertyJournal.h"
+#include "Glass/Properties/SimplePropertyHolder.h"
+#include "Glass/Properties/Types/Builtins.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+namespace {
+	using Glass::PropertyJournal;
+	using Glass::SimplePropertyHolder;
+
+	class PropertyJournalTests : public ::testing::Test {
+	public:
+		void SetUp() override {
+			std::remove(path.c_str());
+			for (auto* holder : {&source, &destination}) {
+				holder->CreateProperty("IntValue", Glass::IntPropertyType::name, 0);
+				holder->CreateProperty("Title", Glass::StringPropertyType::name, std::string{});
+			}
+		}
+
+		void TearDown() override {
+			std::remove(path.c_str());
+			std::remove((path + ".compact").c_str());
+		}
+
+		bool replay() {
+			return Glass::ReplayPropertyJournal(path, [this](uint64_t objectId) {
+				return objectId == 1 ? &destination : nullptr;
+			});
+		}
+
+		size_t getFileSize() {
+			std::ifstream file{path, std::ios::binary | std::ios::ate};
+			return static_cast<size_t>(file.tellg());
+		}
+
+		const std::string path = ::testing::TempDir() + "PropertyJournalTests.journal";
+		SimplePropertyHolder source;
+		SimplePropertyHolder destination;
+	};
+
+	TEST_F(PropertyJournalTests, ReplayAppliesLatestRecords) {
+		{
+			PropertyJournal journal{path};
+			ASSERT_TRUE(journal.IsOpen());
+			source.SetProperty("IntValue", int32_t{1});
+			ASSERT_TRUE(journal.Record(1, source, "IntValue"));
+			ASSERT_TRUE(journal.Flush());
+			source.SetProperty("IntValue", int32_t{2});
+			source.SetProperty("Title", std::string{"hello"});
+			ASSERT_TRUE(journal.Record(1, source, "IntValue"));
+			ASSERT_TRUE(journal.Record(1, source, "Title"));
+			ASSERT_FALSE(journal.Record(1, source, "Missing"));
+			// Records for other objects are skipped when replaying
+			journal.Record(2, "IntValue", "3");
+			ASSERT_TRUE(journal.Flush());
+		}
+
+		const auto version = destination.GetVersion();
+		ASSERT_TRUE(replay());
+		ASSERT_EQ(2, *destination.GetProperty<int32_t>("IntValue"));
+		ASSERT_EQ(std::string{"hello"}, *destination.GetProperty<std::string>("Title"));
+		// Only the latest record of each property is applied
+		ASSERT_EQ(version + 2, destination.GetVersion());
+	}
+
+	TEST_F(PropertyJournalTests, RecordsAreWrittenByFlush) {
+		PropertyJournal journal{path};
+		const auto emptySize = getFileSize();
+		journal.Record(1, "IntValue", "5");
+		journal.Record(1, "Title", "hello");
+		ASSERT_EQ(emptySize, getFileSize());
+		ASSERT_TRUE(journal.Flush());
+		ASSERT_EQ(0u, journal.GetPendingSize());
+		ASSERT_LT(emptySize, getFileSize());
+		ASSERT_TRUE(replay());
+		ASSERT_EQ(5, *destination.GetProperty<int32_t>("IntValue"));
+	}
+
+	TEST_F(PropertyJournalTests, TornBatchIsIgnored) {
+		size_t firstBatchSize = 0;
+		{
+			PropertyJournal journal{path};
+			journal.Record(1, "IntValue", "5");
+			ASSERT_TRUE(journal.Flush());
+			firstBatchSize = getFileSize();
+			journal.Record(1, "IntValue", "6");
+			journal.Record(1, "Title", "hello");
+			ASSERT_TRUE(journal.Flush());
+		}
+		// Simulate a crash partway through writing the second batch, after its first record
+		std::filesystem::resize_file(path, getFileSize() - 3);
+		ASSERT_TRUE(replay());
+		// None of the torn batch is applied, including its complete record
+		ASSERT_EQ(5, *destination.GetProperty<int32_t>("IntValue"));
+		ASSERT_EQ(std::string{}, *destination.GetProperty<std::string>("Title"));
+
+		// Reopening drops the torn batch, so new batches are replayed
+		{
+			PropertyJournal journal{path};
+			ASSERT_TRUE(journal.IsOpen());
+			ASSERT_EQ(firstBatchSize, getFileSize());
+			journal.Record(1, "Title", "goodbye");
+			ASSERT_TRUE(journal.Flush());
+		}
+		ASSERT_TRUE(replay());
+		ASSERT_EQ(std::string{"goodbye"}, *destination.GetProperty<std::string>("Title"));
+	}
+
+	TEST_F(PropertyJournalTests, CorruptBatchStopsReplay) {
+		{
+			PropertyJournal journal{path};
+			journal.Record(1, "IntValue", "5");
+			ASSERT_TRUE(journal.Flush());
+			journal.Record(1, "Title", "hello");
+			journal.Record(1, "IntValue", "6");
+			ASSERT_TRUE(journal.Flush());
+		}
+		{
+			std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+			file.seekp(-1, std::ios::end);
+			file.put('7');
+		}
+		ASSERT_TRUE(replay());
+		ASSERT_EQ(5, *destination.GetProperty<int32_t>("IntValue"));
+		ASSERT_EQ(std::string{}, *destination.GetProperty<std::string>("Title"));
+	}
+
+	TEST_F(PropertyJournalTests, CompactionKeepsLatestRecords) {
+		PropertyJournal journal{path};
+		for (int i = 0; i < 100; ++i) {
+			journal.Record(1, "IntValue", std::to_string(i));
+			journal.Record(1, "Title", "title " + std::to_string(i));
+			ASSERT_TRUE(journal.Flush());
+		}
+		const auto uncompactedSize = getFileSize();
+
+		ASSERT_TRUE(journal.StartCompaction());
+		journal.Record(1, "Title", "after compaction started");
+		ASSERT_TRUE(journal.Flush());
+		ASSERT_TRUE(journal.WaitForCompaction());
+		ASSERT_GT(uncompactedSize / 10, getFileSize());
+
+		journal.Record(1, "IntValue", "1000");
+		ASSERT_TRUE(journal.Flush());
+		ASSERT_TRUE(replay());
+		ASSERT_EQ(1000, *destination.GetProperty<int32_t>("IntValue"));
+		ASSERT_EQ(std::string{"after compaction started"},
+		          *destination.GetProperty<std::string>("Title"));
+
+		// Compacting again folds the records carried over and appended since
+		ASSERT_TRUE(journal.StartCompaction());
+		ASSERT_TRUE(journal.WaitForCompaction());
+		destination.SetProperty("IntValue", int32_t{0});
+		ASSERT_TRUE(replay());
+		ASSERT_EQ(1000, *destination.GetProperty<int32_t>("IntValue"));
+	}
+
+	TEST_F(PropertyJournalTests, OtherFilesAreLeftAlone) {
+		{
+			std::ofstream file{path, std::ios::binary};
+			file << "not a journal";
+		}
+		{
+			PropertyJournal journal{path};
+			ASSERT_FALSE(journal.IsOpen());
+			journal.Record(1, "IntValue", "5");
+			ASSERT_FALSE(journal.Flush());
+			ASSERT_FALSE(journal.StartCompaction());
+		}
+		ASSERT_FALSE(replay());
+		std::ifstream file{path, std::ios::binary};
+		std::string contents;
+		std::getline(file, contents);
+		ASSERT_EQ(std::string{"not a journal"}, contents);
+	}
+
+	TEST_F(PropertyJournalTests, MissingJournal) {
+		ASSERT_FALSE(replay());
+	}
+}
@@ -15,6 +15,12 @@
 
 #pragma once
 
+#include <array>
+#include <optional>
+#include <string_view>
+
+#include "Glass/Properties/Private/PerfectHash.h"
+#include "Glass/Properties/Private/getName.h"
 #include "Glass/Properties/PropertyDefinition.h"
 
 namespace Glass {
@@ -29,6 +35,13 @@ namespace Glass {
 		constexpr bool is_type_in_list(PropertyList<LTs...>) {
 			return (std::is_same_v<T, LTs> || ...);
 		}
+
+		template <typename T, typename... LTs>
+		constexpr size_t position_in_list(PropertyList<LTs...>) {
+			size_t position = 0;
+			static_cast<void>(((std::is_same_v<T, LTs> ? true : (++position, false)) || ...));
+			return position;
+		}
 	}
 
 	//! Used to determine if a PropertyDefinition is a member of a PropertyList
@@ -42,6 +55,47 @@ namespace Glass {
 
 	template <typename... Ts> constexpr inline bool IsPropertyList<PropertyList<Ts...>> = true;
 
+	//! Number of property definitions in a PropertyList
+	template <typename L> constexpr inline size_t PropertyListSize = 0;
+
+	template <typename... Ts>
+	constexpr inline size_t PropertyListSize<PropertyList<Ts...>> = sizeof...(Ts);
+
+	//! Position of the PropertyDefinition T in the PropertyList L, which must contain it
+	template <typename L, typename T>
+	constexpr inline size_t PropertyListPosition = internal::position_in_list<T>(L{});
+
+	//! Maps the names of the properties in the PropertyList L to their positions in L.
+	//!
+	//! The names are indexed by a minimal perfect hash built at compile time, so finding a name
+	//! is one hash and one string comparison, with nothing built at runtime.  The names must be
+	//! constant expressions and distinct, which is checked at compile time.
+	template <typename L> struct PropertyListIndex;
+
+	template <typename... Ts> struct PropertyListIndex<PropertyList<Ts...>> {
+		static constexpr std::array<std::string_view, sizeof...(Ts)> Names{
+		    std::string_view{Private::getName<Ts>()}...};
+		static_assert(!Private::hasDuplicateNames(Names),
+		              "The properties in a PropertyList must have distinct names");
+
+		static constexpr auto HashIndex = Private::BuildStaticPerfectHashIndex(Names);
+		static_assert(HashIndex.isValid, "No perfect hash was found for the property names");
+
+		//! The position in L of the property named `name`, or std::nullopt if there isn't one
+		static constexpr std::optional<size_t> Find(std::string_view name) {
+			if constexpr (sizeof...(Ts) == 0) {
+				static_cast<void>(name);
+				return std::nullopt;
+			} else {
+				const auto index = HashIndex.GetNameIndex(name);
+				if (Names[index] != name) {
+					return std::nullopt;
+				}
+				return index;
+			}
+		}
+	};
+
 
 	//! A vector of instantiated PropertyDefinition
 	using PropertyDefinitionList = vector<unique_ptr<PropertyDefinitionBase>>;
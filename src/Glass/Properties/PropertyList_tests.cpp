@@ -54,3 +54,17 @@ static_assert(PropertyListHasType<typename detail::Properties, ThingTwo>,
 static_assert(!PropertyListHasType<typename detail::Properties, Cat>,
               "PropertyListHasType<Properties, ThingOne>::value == true, "
               "should be false.");
+
+static_assert(PropertyListSize<typename detail::Properties> == 2,
+              "PropertyListSize<Properties> should be 2.");
+static_assert(PropertyListSize<PropertyList<>> == 0,
+              "PropertyListSize<PropertyList<>> should be 0.");
+
+static_assert(PropertyListIndex<typename detail::Properties>::Find("Thing 1") == size_t{0},
+              "Thing 1 should be the first property.");
+static_assert(PropertyListIndex<typename detail::Properties>::Find("Thing 2") == size_t{1},
+              "Thing 2 should be the second property.");
+static_assert(!PropertyListIndex<typename detail::Properties>::Find("Cat"),
+              "Cat isn't in Properties.");
+static_assert(!PropertyListIndex<PropertyList<>>::Find("Thing 1"),
+              "PropertyList<> has no properties.");
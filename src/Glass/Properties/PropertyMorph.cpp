@@ -0,0 +1,33 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/PropertyMorph.h"
+
+void Glass::Private::lerpComponents(gsl::span<const float> from,
+                                    gsl::span<const float> to,
+                                    float t,
+                                    gsl::span<float> out) {
+	ZASSERT(from.size() == out.size() && to.size() == out.size());
+	const auto size = static_cast<size_t>(out.size());
+	const auto* fromData = from.data();
+	const auto* toData = to.data();
+	auto* outData = out.data();
+	for (size_t i = 0; i < size; ++i) {
+		outData[i] = fromData[i] + (toData[i] - fromData[i]) * t;
+	}
+}
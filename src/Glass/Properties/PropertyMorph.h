@@ -0,0 +1,216 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include <array>
+#include <optional>
+
+#include "gsl/span"
+
+#include "Glass/Properties/HasProperties.h"
+#include "Glass/Properties/PropertySnapshot.h"
+#include "Glass/Properties/Types/Meta.h"
+
+namespace Glass {
+	namespace Private {
+		//! Set each of `out` to the value at `t` between `from` and `to`, which all have the same
+		//! size.  This is a plain loop over contiguous floats, which the compiler vectorizes.
+		void lerpComponents(gsl::span<const float> from,
+		                    gsl::span<const float> to,
+		                    float t,
+		                    gsl::span<float> out);
+
+		//! Where the interpolated components of each property of the PropertyList L are in the
+		//! components of a whole snapshot of L
+		template <typename L> struct MorphLayout;
+
+		template <typename... Ts> struct MorphLayout<PropertyList<Ts...>> {
+			static constexpr std::array<size_t, sizeof...(Ts)> Counts{
+			    InterpolationComponentCount_v<typename Ts::property_type>...};
+
+			static constexpr auto Offsets = [] {
+				std::array<size_t, sizeof...(Ts)> offsets{};
+				size_t offset = 0;
+				for (size_t i = 0; i < offsets.size(); ++i) {
+					offsets[i] = offset;
+					offset += Counts[i];
+				}
+				return offsets;
+			}();
+
+			static constexpr size_t ComponentCount = (size_t{0} + ... +
+			                                          InterpolationComponentCount_v<
+			                                              typename Ts::property_type>);
+
+			//! Write the components of every interpolated property of `snapshot`
+			static void toComponents(const PropertySnapshot<PropertyList<Ts...>>& snapshot,
+			                         gsl::span<float> components) {
+				toComponents(snapshot, components, std::index_sequence_for<Ts...>{});
+			}
+
+			//! Set the interpolated properties of `snapshot` from `components`, and the others
+			//! to their values in `from` or `to`, whichever `isPastMidpoint` picks.  Properties
+			//! that aren't interpolated are only assigned if `shouldStep` is true.
+			static void fromComponents(gsl::span<const float> components,
+			                           const PropertySnapshot<PropertyList<Ts...>>& from,
+			                           const PropertySnapshot<PropertyList<Ts...>>& to,
+			                           bool isPastMidpoint,
+			                           bool shouldStep,
+			                           PropertySnapshot<PropertyList<Ts...>>& snapshot) {
+				fromComponents(components,
+				               from,
+				               to,
+				               isPastMidpoint,
+				               shouldStep,
+				               snapshot,
+				               std::index_sequence_for<Ts...>{});
+			}
+
+		private:
+			template <size_t... I>
+			static void toComponents(const PropertySnapshot<PropertyList<Ts...>>& snapshot,
+			                         gsl::span<float> components,
+			                         std::index_sequence<I...>) {
+				(
+				    [&] {
+					    using T = typename Ts::property_type;
+					    if constexpr (HasInterpolation_v<T>) {
+						    T::toComponents(std::get<I>(snapshot.values),
+						                    components.subspan(Offsets[I], Counts[I]));
+					    }
+				    }(),
+				    ...);
+			}
+
+			template <size_t... I>
+			static void fromComponents(gsl::span<const float> components,
+			                           const PropertySnapshot<PropertyList<Ts...>>& from,
+			                           const PropertySnapshot<PropertyList<Ts...>>& to,
+			                           bool isPastMidpoint,
+			                           bool shouldStep,
+			                           PropertySnapshot<PropertyList<Ts...>>& snapshot,
+			                           std::index_sequence<I...>) {
+				(
+				    [&] {
+					    using T = typename Ts::property_type;
+					    auto& value = std::get<I>(snapshot.values);
+					    if constexpr (HasInterpolation_v<T>) {
+						    value = T::fromComponents(components.subspan(Offsets[I], Counts[I]),
+						                              std::get<I>(from.values),
+						                              std::get<I>(to.values));
+					    } else if (shouldStep) {
+						    value = std::get<I>(isPastMidpoint ? to.values : from.values);
+					    }
+				    }(),
+				    ...);
+			}
+		};
+	}
+
+	//! The snapshot at `t` between `from` and `to`.  Properties whose types can be interpolated
+	//! (see PropertyType) are blended, and the others take their values from `from` before the
+	//! midpoint and from `to` after it.  `t` is normally in [0, 1], but isn't clamped.
+	template <typename L>
+	PropertySnapshot<L>
+	MorphSnapshots(const PropertySnapshot<L>& from, const PropertySnapshot<L>& to, float t) {
+		using Layout = Private::MorphLayout<L>;
+		std::array<float, Layout::ComponentCount> fromComponents;
+		std::array<float, Layout::ComponentCount> toComponents;
+		Layout::toComponents(from, fromComponents);
+		Layout::toComponents(to, toComponents);
+		Private::lerpComponents(fromComponents, toComponents, t, fromComponents);
+		const auto isPastMidpoint = t >= .5f;
+		auto snapshot = isPastMidpoint ? to : from;
+		Layout::fromComponents(fromComponents, from, to, isPastMidpoint, false, snapshot);
+		return snapshot;
+	}
+
+	//! Morphs any number of objects of class U, each between two snapshots of its PropertyList
+	//! L, as MorphSnapshots does.
+	//!
+	//! Apply blends the components of every object's interpolated properties in a single pass
+	//! over contiguous arrays, then restores each object to its blended snapshot, so only the
+	//! properties that changed since the last frame fire signals.  Like animated values,
+	//! morphed values aren't recorded in an undo history.  Objects must outlive the morph, or
+	//! be removed from it with Clear.
+	template <typename U, typename L> class PropertyMorph {
+	public:
+		void AddObject(U& object, PropertySnapshot<L> from, PropertySnapshot<L> to) {
+			const auto offset = m_fromComponents.size();
+			m_fromComponents.resize(offset + Layout::ComponentCount);
+			m_toComponents.resize(offset + Layout::ComponentCount);
+			m_components.resize(offset + Layout::ComponentCount);
+			Layout::toComponents(
+			    from, gsl::span<float>{m_fromComponents}.subspan(offset, Layout::ComponentCount));
+			Layout::toComponents(
+			    to, gsl::span<float>{m_toComponents}.subspan(offset, Layout::ComponentCount));
+			auto current = object.template Snapshot<L>();
+			m_objects.push_back(
+			    Object{&object, std::move(from), std::move(to), std::move(current)});
+			m_isPastMidpoint.reset();
+		}
+
+		void Clear() {
+			m_objects.clear();
+			m_fromComponents.clear();
+			m_toComponents.clear();
+			m_components.clear();
+		}
+
+		size_t GetObjectCount() const { return m_objects.size(); }
+
+		//! Set every object to its snapshot at `t` (see MorphSnapshots)
+		void Apply(float t) {
+			Private::lerpComponents(m_fromComponents, m_toComponents, t, m_components);
+			const auto isPastMidpoint = t >= .5f;
+			// Properties that aren't interpolated only change when t crosses the midpoint
+			const auto shouldStep = m_isPastMidpoint != isPastMidpoint;
+			m_isPastMidpoint = isPastMidpoint;
+			const auto components = gsl::span<const float>{m_components};
+			for (size_t i = 0; i < m_objects.size(); ++i) {
+				auto& object = m_objects[i];
+				Layout::fromComponents(
+				    components.subspan(i * Layout::ComponentCount, Layout::ComponentCount),
+				    object.from,
+				    object.to,
+				    isPastMidpoint,
+				    shouldStep,
+				    object.current);
+				static_cast<HasProperties<U, L>&>(*object.object).restore(object.current, false);
+			}
+		}
+
+	private:
+		using Layout = Private::MorphLayout<L>;
+
+		struct Object {
+			U* object;
+			PropertySnapshot<L> from;
+			PropertySnapshot<L> to;
+			//! The snapshot last applied to the object, reused to avoid reallocating values
+			PropertySnapshot<L> current;
+		};
+
+		vector<Object> m_objects;
+		//! The components of every object, one after another
+		vector<float> m_fromComponents;
+		vector<float> m_toComponents;
+		vector<float> m_components;
+		//! Empty until the first Apply after objects are added
+		std::optional<bool> m_isPastMidpoint;
+	};
+}
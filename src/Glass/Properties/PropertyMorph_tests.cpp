@@ -0,0 +1,141 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/HasProperties.h"
+#include "Glass/Properties/HasPropertiesBase.h"
+#include "Glass/Properties/PropertyMorph.h"
+#include "Glass/Properties/Types/Builtins.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+namespace {
+	struct Opacity : Glass::PropertyDefinition<Opacity, Glass::FloatPropertyType> {
+		static constexpr const char* const name = "Opacity";
+		static constexpr float defaultValue = 0.f;
+	};
+
+	struct Padding : Glass::PropertyDefinition<Padding, Glass::Float4DimPropertyType> {
+		static constexpr const char* const name = "Padding";
+		static Glass::Float4Dim defaultValue() { return Glass::Float4Dim{0.f}; }
+	};
+
+	struct Columns : Glass::PropertyDefinition<Columns, Glass::IntPropertyType> {
+		static constexpr const char* const name = "Columns";
+		static constexpr int32_t defaultValue = 1;
+	};
+
+	using Properties = Glass::PropertyList<Opacity, Padding, Columns>;
+
+	struct Widget : public Glass::HasPropertiesBase,
+	                public Glass::HasProperties<Widget, Properties> {
+		void didSet(Columns) { ++columnsSetCount; }
+
+		size_t columnsSetCount = 0;
+	};
+
+	using Snapshot = Glass::PropertySnapshot<Properties>;
+
+	Snapshot makeSnapshot(float opacity, Glass::Float4Dim padding, int32_t columns) {
+		return Snapshot{{opacity, padding, columns}};
+	}
+}
+
+static_assert(Glass::HasInterpolation_v<Glass::FloatPropertyType>);
+static_assert(Glass::HasInterpolation_v<Glass::Float4DimPropertyType>);
+static_assert(!Glass::HasInterpolation_v<Glass::IntPropertyType>);
+static_assert(Glass::Private::MorphLayout<Properties>::ComponentCount == 5);
+
+TEST(PropertyMorph, LerpComponents) {
+	const vector<float> from{0.f, 1.f, -2.f, 4.f, 10.f};
+	const vector<float> to{1.f, 1.f, 2.f, 0.f, 20.f};
+	vector<float> out(from.size());
+	Glass::Private::lerpComponents(from, to, .25f, out);
+	ASSERT_EQ((vector<float>{.25f, 1.f, -1.f, 3.f, 12.5f}), out);
+}
+
+TEST(PropertyMorph, MorphSnapshots) {
+	const auto from = makeSnapshot(0.f, Glass::Float4Dim{2.f}, 1);
+	const auto to =
+	    makeSnapshot(1.f, Glass::Float4Dim{std::array<float, 4>{4.f, 6.f, 2.f, 2.f}}, 3);
+
+	const auto quarter = Glass::MorphSnapshots(from, to, .25f);
+	ASSERT_EQ(.25f, quarter.Get<Opacity>());
+	ASSERT_TRUE((Glass::Float4Dim{std::array<float, 4>{2.5f, 3.f, 2.f, 2.f}} ==
+	             quarter.Get<Padding>()));
+	ASSERT_EQ(1, quarter.Get<Columns>());
+
+	const auto threeQuarters = Glass::MorphSnapshots(from, to, .75f);
+	ASSERT_EQ(.75f, threeQuarters.Get<Opacity>());
+	ASSERT_EQ(3, threeQuarters.Get<Columns>());
+
+	// Single values stay single if both ends are
+	const auto singleTo = makeSnapshot(1.f, Glass::Float4Dim{4.f}, 1);
+	const auto half = Glass::MorphSnapshots(from, singleTo, .5f);
+	const auto* single = boost::get<float>(&half.Get<Padding>());
+	ASSERT_TRUE(single);
+	ASSERT_EQ(3.f, *single);
+}
+
+TEST(PropertyMorph, Apply) {
+	Widget first;
+	Widget second;
+	Glass::PropertyMorph<Widget, Properties> morph;
+	morph.AddObject(first,
+	                makeSnapshot(0.f, Glass::Float4Dim{0.f}, 1),
+	                makeSnapshot(1.f, Glass::Float4Dim{4.f}, 2));
+	morph.AddObject(second,
+	                makeSnapshot(1.f, Glass::Float4Dim{0.f}, 1),
+	                makeSnapshot(0.f, Glass::Float4Dim{0.f}, 1));
+	ASSERT_EQ(2u, morph.GetObjectCount());
+
+	morph.Apply(.25f);
+	ASSERT_EQ(.25f, first.GetProperty<Opacity>());
+	ASSERT_TRUE(Glass::Float4Dim{1.f} == first.GetProperty<Padding>());
+	ASSERT_EQ(.75f, second.GetProperty<Opacity>());
+	// Only changed properties are set
+	ASSERT_EQ(std::bitset<3>{"011"}, first.ConsumeDirty());
+	ASSERT_EQ(std::bitset<3>{"001"}, second.ConsumeDirty());
+	ASSERT_EQ(0u, first.columnsSetCount);
+
+	morph.Apply(.5f);
+	morph.Apply(1.f);
+	ASSERT_EQ(1.f, first.GetProperty<Opacity>());
+	ASSERT_TRUE(Glass::Float4Dim{4.f} == first.GetProperty<Padding>());
+	ASSERT_EQ(2, first.GetProperty<Columns>());
+	ASSERT_EQ(1u, first.columnsSetCount);
+	ASSERT_EQ(0.f, second.GetProperty<Opacity>());
+
+	morph.Clear();
+	ASSERT_EQ(0u, morph.GetObjectCount());
+}
+
+TEST(PropertyMorph, ApplyIsntRecordedInUndoHistory) {
+	Glass::PropertyUndoHistory history;
+	Widget widget;
+	widget.SetUndoHistory(&history);
+	Glass::PropertyMorph<Widget, Properties> morph;
+	morph.AddObject(widget,
+	                makeSnapshot(0.f, Glass::Float4Dim{0.f}, 1),
+	                makeSnapshot(1.f, Glass::Float4Dim{4.f}, 2));
+	morph.Apply(.25f);
+	morph.Apply(1.f);
+	ASSERT_EQ(2, widget.GetProperty<Columns>());
+	ASSERT_EQ(0u, history.GetUndoCount());
+}
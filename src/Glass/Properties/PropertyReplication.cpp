@@ -0,0 +1,245 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/PropertyReplication.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <cerrno>
+#include <sys/socket.h>
+#endif
+
+#include "Glass/Properties/HasPropertiesBase.h"
+#include "Glass/Properties/SimplePropertyHolder.h"
+#include "Glass/Properties/Types/BinaryCodec.h"
+
+// Message format:
+//   uint32_t change count
+//   changes, each:
+//     uint64_t object id
+//     uint32_t property number
+//     uint32_t size, followed by the value written by SimplePropertyHolder::EncodeProperty
+
+using Glass::PropertyReplicationStream;
+using Glass::PropertyReplicator;
+
+void PropertyReplicator::AddObject(uint64_t objectId, SimplePropertyHolder& holder) {
+	m_objects[objectId] = ReplicatedObject{&holder, 0};
+}
+
+void PropertyReplicator::AddObject(uint64_t objectId, HasPropertiesBase& object) {
+	AddObject(objectId, *object.m_propertyHolder);
+}
+
+void PropertyReplicator::RemoveObject(uint64_t objectId) {
+	m_objects.erase(objectId);
+}
+
+vector<uint8_t> PropertyReplicator::CollectChanges() {
+	BinaryWriter writer;
+	writer.WriteSize(0);
+	size_t changeCount = 0;
+	for (auto& [objectId, object] : m_objects) {
+		auto& holder = *object.holder;
+		const auto version = holder.GetVersion();
+		if (version == object.collectedVersion) {
+			continue;
+		}
+		for (size_t i = 0; i < holder.GetPropertyCount(); ++i) {
+			if (holder.GetPropertyVersion(i) <= object.collectedVersion) {
+				continue;
+			}
+			const auto changeOffset = writer.GetSize();
+			writer.Write(objectId);
+			writer.WriteSize(i);
+			const auto sizeOffset = writer.GetSize();
+			writer.WriteSize(0);
+			if (!holder.EncodeProperty(i, writer)) {
+				writer.Truncate(changeOffset);
+				continue;
+			}
+			writer.PatchSize(sizeOffset, writer.GetSize() - sizeOffset - sizeof(uint32_t));
+			++changeCount;
+		}
+		object.collectedVersion = version;
+	}
+	if (changeCount == 0) {
+		return {};
+	}
+	writer.PatchSize(0, changeCount);
+	return writer.TakeBuffer();
+}
+
+bool PropertyReplicator::ApplyChanges(const uint8_t* data, size_t size) {
+	BinaryReader reader{data, size};
+	const auto changeCount = reader.ReadSize();
+	if (!changeCount) {
+		return false;
+	}
+	for (size_t i = 0; i < *changeCount; ++i) {
+		const auto objectId = reader.Read<uint64_t>();
+		const auto index = reader.ReadSize();
+		const auto valueSize = reader.ReadSize();
+		if (!objectId || !index || !valueSize) {
+			return false;
+		}
+		auto valueReader = reader.ReadSubReader(*valueSize);
+		if (!valueReader) {
+			return false;
+		}
+
+		const auto it = m_objects.find(*objectId);
+		if (it == m_objects.end() || *index >= it->second.holder->GetPropertyCount()) {
+			continue;
+		}
+		auto& object = it->second;
+		auto& holder = *object.holder;
+		// Don't send the value back, unless there are local changes to collect anyway or the
+		// property's signal handlers set other properties
+		const auto version = holder.GetVersion();
+		if (!holder.DecodeProperty(*index, *valueReader)) {
+			ZERROR("Failed to decode replicated property value.");
+			continue;
+		}
+		if (object.collectedVersion == version && holder.GetVersion() == version + 1) {
+			object.collectedVersion = version + 1;
+		}
+	}
+	return reader.IsAtEnd();
+}
+
+bool PropertyReplicationStream::WriteMessage(const vector<uint8_t>& message) {
+	if (message.size() > MaxMessageSize) {
+		return false;
+	}
+	const auto size = static_cast<uint32_t>(message.size());
+	return writeBytes(reinterpret_cast<const uint8_t*>(&size), sizeof(size)) &&
+	       writeBytes(message.data(), message.size());
+}
+
+std::optional<vector<uint8_t>> PropertyReplicationStream::ReadMessage() {
+	uint32_t size = 0;
+	if (!readBytes(reinterpret_cast<uint8_t*>(&size), sizeof(size))) {
+		return std::nullopt;
+	}
+	if (size > MaxMessageSize) {
+		ZERROR("Replicated message is too large.");
+		shutdown();
+		return std::nullopt;
+	}
+	vector<uint8_t> message(size);
+	if (!readBytes(message.data(), message.size())) {
+		return std::nullopt;
+	}
+	return message;
+}
+
+#ifdef _WIN32
+PropertyReplicationStream::PropertyReplicationStream(Socket socket)
+    : m_socket{socket} {}
+
+bool PropertyReplicationStream::writeBytes(const uint8_t* data, size_t size) {
+	while (size > 0) {
+		const auto chunk = static_cast<int>(std::min<size_t>(size, 1 << 30));
+		const auto sent = ::send(
+		    static_cast<SOCKET>(m_socket), reinterpret_cast<const char*>(data), chunk, 0);
+		if (sent == SOCKET_ERROR) {
+			return false;
+		}
+		data += sent;
+		size -= static_cast<size_t>(sent);
+	}
+	return true;
+}
+
+bool PropertyReplicationStream::readBytes(uint8_t* data, size_t size) {
+	while (size > 0) {
+		const auto chunk = static_cast<int>(std::min<size_t>(size, 1 << 30));
+		const auto received =
+		    ::recv(static_cast<SOCKET>(m_socket), reinterpret_cast<char*>(data), chunk, 0);
+		if (received == SOCKET_ERROR || received == 0) {
+			return false;
+		}
+		data += received;
+		size -= static_cast<size_t>(received);
+	}
+	return true;
+}
+
+void PropertyReplicationStream::shutdown() {
+	::shutdown(static_cast<SOCKET>(m_socket), SD_BOTH);
+}
+#else
+namespace {
+#ifdef MSG_NOSIGNAL
+	// Report a closed peer as an error rather than raising SIGPIPE
+	constexpr int SendFlags = MSG_NOSIGNAL;
+#else
+	// SO_NOSIGPIPE is set on the socket instead, see the constructor
+	constexpr int SendFlags = 0;
+#endif
+}
+
+PropertyReplicationStream::PropertyReplicationStream(Socket socket)
+    : m_socket{socket} {
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+	const int isEnabled = 1;
+	::setsockopt(m_socket, SOL_SOCKET, SO_NOSIGPIPE, &isEnabled, sizeof(isEnabled));
+#endif
+}
+
+bool PropertyReplicationStream::writeBytes(const uint8_t* data, size_t size) {
+	while (size > 0) {
+		const auto sent = ::send(m_socket, data, size, SendFlags);
+		if (sent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		data += sent;
+		size -= static_cast<size_t>(sent);
+	}
+	return true;
+}
+
+bool PropertyReplicationStream::readBytes(uint8_t* data, size_t size) {
+	while (size > 0) {
+		const auto received = ::recv(m_socket, data, size, 0);
+		if (received < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		if (received == 0) {
+			return false;
+		}
+		data += received;
+		size -= static_cast<size_t>(received);
+	}
+	return true;
+}
+
+void PropertyReplicationStream::shutdown() {
+	::shutdown(m_socket, SHUT_RDWR);
+}
+#endif
@@ -0,0 +1,107 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace Glass {
+	class HasPropertiesBase;
+	class SimplePropertyHolder;
+
+	//! Keeps the properties of objects in two processes in sync, e.g., a plugin's UI and its
+	//! DSP host.
+	//!
+	//! Each side adds the objects it shares under ids both sides agree on.  Once per frame,
+	//! CollectChanges encodes every property set since the last call into one message of
+	//! (object id, property number, value) changes, with each property's latest value only.
+	//! The other side passes the message to ApplyChanges.  Values are encoded with their
+	//! types' binary codecs where there are any, and with their registered serializers
+	//! otherwise (see SimplePropertyHolder::EncodeProperty).
+	//!
+	//! Properties are matched by number, so both sides must create each object's properties
+	//! in the same order, as HasProperties does for objects of the same class.
+	//!
+	//! Changes can flow both ways.  Properties set by ApplyChanges aren't sent back, unless
+	//! the object also had local changes that hadn't been collected yet, in which case the
+	//! applied values are echoed once and then settle.
+	class PropertyReplicator {
+	public:
+		//! Replicate `holder` as `objectId`.  Properties set before the object was added are
+		//! included in the next CollectChanges.
+		void AddObject(uint64_t objectId, SimplePropertyHolder& holder);
+		void AddObject(uint64_t objectId, HasPropertiesBase& object);
+		void RemoveObject(uint64_t objectId);
+
+		//! Encode the properties set since the last call, or an empty message if there are none
+		vector<uint8_t> CollectChanges();
+
+		//! Apply a message from CollectChanges on the other side, firing the signal of each
+		//! property that is set.  Changes to unknown objects or properties, or that fail to
+		//! decode, are skipped.  Returns false if the message is malformed, in which case the
+		//! changes before the error have been applied.
+		bool ApplyChanges(const uint8_t* data, size_t size);
+
+	private:
+		struct ReplicatedObject {
+			SimplePropertyHolder* holder;
+			//! The holder's version when its changes were last collected
+			uint64_t collectedVersion;
+		};
+
+		std::unordered_map<uint64_t, ReplicatedObject> m_objects;
+	};
+
+	//! Sends whole messages over a connected local stream socket, such as one end of a
+	//! socketpair or a Unix domain socket.  Each message is prefixed with its size.  The
+	//! socket is not owned, and is used in blocking mode.
+	class PropertyReplicationStream {
+	public:
+#ifdef _WIN32
+		using Socket = uintptr_t;
+#else
+		using Socket = int;
+#endif
+
+		//! Largest message that is sent or received.  The size prefix comes from the peer, so
+		//! without a limit a malformed or hostile peer could make the reader allocate up to
+		//! 4 GiB.
+		static constexpr uint32_t MaxMessageSize = 64 << 20;
+
+		//! Where send has no MSG_NOSIGNAL flag, such as on macOS, this sets SO_NOSIGPIPE on
+		//! `socket`, so that writing to a closed peer fails instead of raising SIGPIPE and
+		//! killing the process.
+		explicit PropertyReplicationStream(Socket socket);
+
+		//! Returns false if the socket was closed or failed, or if `message` is larger than
+		//! MaxMessageSize
+		bool WriteMessage(const vector<uint8_t>& message);
+
+		//! Block until a whole message arrives.  Returns std::nullopt if the socket was closed
+		//! or failed.  A message larger than MaxMessageSize is rejected the same way, and the
+		//! connection is shut down, since the rest of the stream can't be trusted.
+		std::optional<vector<uint8_t>> ReadMessage();
+
+	private:
+		bool writeBytes(const uint8_t* data, size_t size);
+		bool readBytes(uint8_t* data, size_t size);
+		//! Shut down both directions of the connection, without closing the socket
+		void shutdown();
+
+		Socket m_socket;
+	};
+}
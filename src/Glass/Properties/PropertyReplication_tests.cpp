@@ -0,0 +1,212 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "Glass/Properties/HasProperties.h"
+#include "Glass/Properties/HasPropertiesBase.h"
+#include "Glass/Properties/Private/GlobalPropertyData.h"
+#include "Glass/Properties/PropertyReplication.h"
+#include "Glass/Properties/SimplePropertyHolder.h"
+#include "Glass/Properties/Types/Builtins.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+namespace {
+	using Glass::PropertyReplicator;
+	using Glass::SimplePropertyHolder;
+
+	//! A type with a serializer but no binary codec
+	struct TextOnlyPropertyType : Glass::PropertyType<int32_t> {
+		static constexpr auto name = "TextOnlyInt";
+		static std::string serialize(int32_t value) { return std::to_string(value); }
+		static std::optional<int32_t> deserialize(const std::string& serializedValue) {
+			return std::stoi(serializedValue);
+		}
+	};
+
+	void createProperties(SimplePropertyHolder& holder) {
+		holder.CreateProperty("Int", Glass::IntPropertyType::name, int32_t{0});
+		holder.CreateProperty("Title", Glass::StringPropertyType::name, std::string{});
+		holder.CreateProperty("TextOnly", TextOnlyPropertyType::name, int32_t{0});
+	}
+
+	class PropertyReplicationTests : public ::testing::Test {
+	public:
+		void SetUp() override {
+			Glass::Private::GlobalPropertyData::AddPropertyTypeData<TextOnlyPropertyType>();
+			for (auto* holder : {&source, &destination}) {
+				createProperties(*holder);
+			}
+			sender.AddObject(1, source);
+			receiver.AddObject(1, destination);
+		}
+
+		bool sync(PropertyReplicator& from, PropertyReplicator& to) {
+			const auto message = from.CollectChanges();
+			return message.empty() || to.ApplyChanges(message.data(), message.size());
+		}
+
+		SimplePropertyHolder source;
+		SimplePropertyHolder destination;
+		PropertyReplicator sender;
+		PropertyReplicator receiver;
+	};
+
+	TEST_F(PropertyReplicationTests, ChangesAreApplied) {
+		ASSERT_TRUE(sender.CollectChanges().empty());
+		source.SetProperty("Int", int32_t{5});
+		source.SetProperty("Title", std::string{"hello"});
+		source.SetProperty("TextOnly", int32_t{7});
+		ASSERT_TRUE(sync(sender, receiver));
+		ASSERT_EQ(5, *destination.GetProperty<int32_t>("Int"));
+		ASSERT_EQ(std::string{"hello"}, *destination.GetProperty<std::string>("Title"));
+		ASSERT_EQ(7, *destination.GetProperty<int32_t>("TextOnly"));
+		ASSERT_TRUE(sender.CollectChanges().empty());
+	}
+
+	TEST_F(PropertyReplicationTests, ChangesAreCoalesced) {
+		for (int32_t i = 0; i < 10; ++i) {
+			source.SetProperty("Int", i);
+		}
+		const auto message = sender.CollectChanges();
+		const auto version = destination.GetVersion();
+		ASSERT_TRUE(receiver.ApplyChanges(message.data(), message.size()));
+		ASSERT_EQ(9, *destination.GetProperty<int32_t>("Int"));
+		ASSERT_EQ(version + 1, destination.GetVersion());
+	}
+
+	TEST_F(PropertyReplicationTests, AppliedChangesArentSentBack) {
+		source.SetProperty("Int", int32_t{5});
+		ASSERT_TRUE(sync(sender, receiver));
+		ASSERT_TRUE(receiver.CollectChanges().empty());
+
+		destination.SetProperty("Title", std::string{"reply"});
+		ASSERT_TRUE(sync(receiver, sender));
+		ASSERT_EQ(std::string{"reply"}, *source.GetProperty<std::string>("Title"));
+		ASSERT_TRUE(sender.CollectChanges().empty());
+	}
+
+	TEST_F(PropertyReplicationTests, ConcurrentChangesSettle) {
+		source.SetProperty("Int", int32_t{5});
+		destination.SetProperty("Title", std::string{"local"});
+		ASSERT_TRUE(sync(sender, receiver));
+		ASSERT_TRUE(sync(receiver, sender));
+		ASSERT_TRUE(sync(sender, receiver));
+		ASSERT_TRUE(sender.CollectChanges().empty());
+		ASSERT_TRUE(receiver.CollectChanges().empty());
+		for (auto* holder : {&source, &destination}) {
+			ASSERT_EQ(5, *holder->GetProperty<int32_t>("Int"));
+			ASSERT_EQ(std::string{"local"}, *holder->GetProperty<std::string>("Title"));
+		}
+	}
+
+	TEST_F(PropertyReplicationTests, UnknownObjectsAreSkipped) {
+		SimplePropertyHolder other;
+		createProperties(other);
+		sender.AddObject(2, other);
+		other.SetProperty("Int", int32_t{3});
+		source.SetProperty("Int", int32_t{4});
+		ASSERT_TRUE(sync(sender, receiver));
+		ASSERT_EQ(4, *destination.GetProperty<int32_t>("Int"));
+
+		receiver.RemoveObject(1);
+		source.SetProperty("Int", int32_t{6});
+		ASSERT_TRUE(sync(sender, receiver));
+		ASSERT_EQ(4, *destination.GetProperty<int32_t>("Int"));
+	}
+
+	TEST_F(PropertyReplicationTests, MalformedMessagesFail) {
+		source.SetProperty("Int", int32_t{5});
+		auto message = sender.CollectChanges();
+		message.pop_back();
+		ASSERT_FALSE(receiver.ApplyChanges(message.data(), message.size()));
+		ASSERT_EQ(0, *destination.GetProperty<int32_t>("Int"));
+		ASSERT_FALSE(receiver.ApplyChanges(nullptr, 0));
+	}
+
+	struct Gain : Glass::PropertyDefinition<Gain, Glass::FloatPropertyType> {
+		static constexpr const char* const name = "Gain";
+		static constexpr Glass::FloatPropertyType::type defaultValue = 1.f;
+	};
+
+	struct Plugin : public Glass::HasPropertiesBase,
+	                public Glass::HasProperties<Plugin, Glass::PropertyList<Gain>> {};
+
+	TEST(PropertyReplication, HasProperties) {
+		Plugin ui;
+		Plugin dsp;
+		PropertyReplicator uiReplicator;
+		PropertyReplicator dspReplicator;
+		uiReplicator.AddObject(1, ui);
+		dspReplicator.AddObject(1, dsp);
+
+		ui.SetProperty<Gain>(0.5f);
+		const auto message = uiReplicator.CollectChanges();
+		ASSERT_TRUE(dspReplicator.ApplyChanges(message.data(), message.size()));
+		ASSERT_EQ(0.5f, dsp.GetProperty<Gain>());
+		ASSERT_TRUE(dsp.ConsumeDirty().all());
+	}
+
+#ifndef _WIN32
+	TEST_F(PropertyReplicationTests, Socketpair) {
+		int sockets[2];
+		ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+		Glass::PropertyReplicationStream sourceStream{sockets[0]};
+		Glass::PropertyReplicationStream destinationStream{sockets[1]};
+
+		source.SetProperty("Title", std::string(1000, 'x'));
+		ASSERT_TRUE(sourceStream.WriteMessage(sender.CollectChanges()));
+		source.SetProperty("Int", int32_t{8});
+		ASSERT_TRUE(sourceStream.WriteMessage(sender.CollectChanges()));
+
+		for (int i = 0; i < 2; ++i) {
+			const auto message = destinationStream.ReadMessage();
+			ASSERT_TRUE(message);
+			ASSERT_TRUE(receiver.ApplyChanges(message->data(), message->size()));
+		}
+		ASSERT_EQ(std::string(1000, 'x'), *destination.GetProperty<std::string>("Title"));
+		ASSERT_EQ(8, *destination.GetProperty<int32_t>("Int"));
+
+		::close(sockets[0]);
+		ASSERT_FALSE(destinationStream.ReadMessage());
+		ASSERT_FALSE(destinationStream.WriteMessage({1, 2, 3}));
+		::close(sockets[1]);
+	}
+
+	TEST_F(PropertyReplicationTests, OversizedMessagesCloseTheConnection) {
+		int sockets[2];
+		ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+		Glass::PropertyReplicationStream destinationStream{sockets[1]};
+
+		const uint32_t size = Glass::PropertyReplicationStream::MaxMessageSize + 1;
+		ASSERT_EQ(static_cast<ssize_t>(sizeof(size)), ::send(sockets[0], &size, sizeof(size), 0));
+		ASSERT_FALSE(destinationStream.ReadMessage());
+		// The connection was shut down, so the peer sees it closed
+		uint8_t byte = 0;
+		ASSERT_EQ(0, ::recv(sockets[0], &byte, 1, 0));
+		::close(sockets[0]);
+		::close(sockets[1]);
+	}
+#endif
+}
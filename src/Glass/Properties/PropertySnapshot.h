@@ -0,0 +1,49 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include <tuple>
+
+#include "Glass/Properties/PropertyList.h"
+
+namespace Glass {
+	//! The values of the properties in the PropertyList L of an object, taken by
+	//! HasProperties::Snapshot and given back to HasProperties::Restore.
+	//!
+	//! Values are stored by type, one after another, so copying a snapshot of trivially copyable
+	//! values is a block copy.  Scratch spaces aren't part of a snapshot.
+	template <typename L> struct PropertySnapshot;
+
+	template <typename... Ts> struct PropertySnapshot<PropertyList<Ts...>> {
+		using Values = std::tuple<typename Ts::property_type::type...>;
+
+		template <typename P>
+		std::enable_if_t<PropertyListHasType<PropertyList<Ts...>, P>,
+		                 const typename P::property_type::type&>
+		Get() const {
+			return std::get<PropertyListPosition<PropertyList<Ts...>, P>>(values);
+		}
+
+		template <typename P>
+		std::enable_if_t<PropertyListHasType<PropertyList<Ts...>, P>, void>
+		Set(typename P::property_type::type value) {
+			std::get<PropertyListPosition<PropertyList<Ts...>, P>>(values) = std::move(value);
+		}
+
+		Values values;
+	};
+}
@@ -0,0 +1,164 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/PropertyUndoHistory.h"
+
+#include <algorithm>
+
+#include "Glass/Properties/SimplePropertyHolder.h"
+
+using Glass::PropertyUndoHistory;
+
+namespace {
+	size_t alignUp(size_t offset, size_t alignment) {
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+}
+
+PropertyUndoHistory::PropertyUndoHistory(size_t capacity)
+    : m_buffer(capacity) {}
+
+PropertyUndoHistory::~PropertyUndoHistory() {
+	Clear();
+	for (auto* holder : m_holders) {
+		holder->m_undoHistory = nullptr;
+	}
+}
+
+bool PropertyUndoHistory::Undo() {
+	if (m_position == 0) {
+		return false;
+	}
+	const auto& edit = m_edits[--m_position];
+	m_isMergeBroken = true;
+	restore(edit, getOldValue(edit));
+	return true;
+}
+
+bool PropertyUndoHistory::Redo() {
+	if (m_position == m_edits.size()) {
+		return false;
+	}
+	const auto& edit = m_edits[m_position++];
+	m_isMergeBroken = true;
+	restore(edit, getNewValue(edit));
+	return true;
+}
+
+void PropertyUndoHistory::Clear() {
+	for (const auto& edit : m_edits) {
+		destroy(edit);
+	}
+	m_edits.clear();
+	m_position = 0;
+	m_isMergeBroken = true;
+}
+
+bool PropertyUndoHistory::shouldMerge(const SimplePropertyHolder& holder,
+                                      size_t index,
+                                      const ValueOps& ops) {
+	if (m_isMergeBroken || m_position != m_edits.size() || m_edits.empty()) {
+		return false;
+	}
+	const auto& last = m_edits.back();
+	return last.holder == &holder && last.index == index && last.ops == &ops;
+}
+
+std::byte* PropertyUndoHistory::allocate(const ValueOps& ops) {
+	dropRedo();
+	const auto size = 2 * ops.size;
+	if (size > m_buffer.size()) {
+		Clear();
+		return nullptr;
+	}
+
+	// Edits left from the previous trip around the buffer start at or after the end of the
+	// newest edit, and are the oldest edits
+	const auto end = m_edits.empty() ? 0 : m_edits.back().getEnd();
+	auto offset = alignUp(end, ops.alignment);
+	auto oldestStart = end;
+	if (offset + size > m_buffer.size()) {
+		while (!m_edits.empty() && m_edits.front().offset >= end) {
+			destroy(m_edits.front());
+			m_edits.pop_front();
+		}
+		offset = 0;
+		oldestStart = 0;
+	}
+	while (!m_edits.empty() && m_edits.front().offset >= oldestStart &&
+	       m_edits.front().offset < offset + size) {
+		destroy(m_edits.front());
+		m_edits.pop_front();
+	}
+	m_position = m_edits.size();
+	return m_buffer.data() + offset;
+}
+
+void PropertyUndoHistory::restore(const Edit& edit, const std::byte* value) {
+	// Properties set by the signal handlers of the restored property follow from it, so they
+	// aren't recorded as edits of their own
+	m_isRestoring = true;
+	edit.holder->restoreProperty(edit.index, edit.ops->assignAny, value);
+	m_isRestoring = false;
+}
+
+void PropertyUndoHistory::destroy(const Edit& edit) {
+	if (edit.ops->destroy) {
+		edit.ops->destroy(getOldValue(edit));
+		edit.ops->destroy(getNewValue(edit));
+	}
+}
+
+void PropertyUndoHistory::dropRedo() {
+	while (m_edits.size() > m_position) {
+		destroy(m_edits.back());
+		m_edits.pop_back();
+	}
+}
+
+void PropertyUndoHistory::attach(SimplePropertyHolder& holder) {
+	m_holders.push_back(&holder);
+}
+
+void PropertyUndoHistory::moveHolder(SimplePropertyHolder& from, SimplePropertyHolder& to) {
+	std::replace(m_holders.begin(), m_holders.end(), &from, &to);
+	for (auto& edit : m_edits) {
+		if (edit.holder == &from) {
+			edit.holder = &to;
+		}
+	}
+}
+
+void PropertyUndoHistory::detach(SimplePropertyHolder& holder) {
+	m_holders.erase(std::remove(m_holders.begin(), m_holders.end(), &holder), m_holders.end());
+
+	std::deque<Edit> edits;
+	size_t position = 0;
+	for (size_t i = 0; i < m_edits.size(); ++i) {
+		const auto& edit = m_edits[i];
+		if (edit.holder == &holder) {
+			destroy(edit);
+		} else {
+			edits.push_back(edit);
+			position += i < m_position ? 1 : 0;
+		}
+	}
+	m_edits = std::move(edits);
+	m_position = position;
+	m_isMergeBroken = true;
+}
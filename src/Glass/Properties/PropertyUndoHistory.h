@@ -0,0 +1,193 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <type_traits>
+
+namespace Glass {
+	class SimplePropertyHolder;
+
+	//! Undo and redo history of property edits.
+	//!
+	//! Attach a history to holders with SimplePropertyHolder::SetUndoHistory (or
+	//! HasPropertiesBase::SetUndoHistory), and every SetProperty and ModifyProperty on them
+	//! records the property's number and its old and new values.  Undo and Redo set the values
+	//! back directly, without serializing anything, and fire the properties' signals as any
+	//! other set would.  Properties set by those signals' handlers aren't recorded.
+	//! Deserializing a property isn't an edit, so it isn't recorded either.
+	//!
+	//! Values are stored in a fixed size ring buffer, with each edit's old and new values next
+	//! to each other.  Trivially copyable values are copied in and out with memcpy, and other
+	//! values are constructed in place.  When the buffer is full, the oldest edits are dropped.
+	//!
+	//! Consecutive edits of the same property are merged into one step, keeping the oldest
+	//! value, so dragging a slider is undone in one go.  Call BreakMerge at the end of each user
+	//! gesture so the next one gets its own step.
+	class PropertyUndoHistory {
+	public:
+		//! `capacity` is the size in bytes of the buffer that holds the edited values
+		explicit PropertyUndoHistory(size_t capacity = 1 << 20);
+		//! Detaches every holder attached to this history
+		~PropertyUndoHistory();
+
+		PropertyUndoHistory(const PropertyUndoHistory&) = delete;
+		PropertyUndoHistory& operator=(const PropertyUndoHistory&) = delete;
+
+		//! Set the property changed by the most recent edit back to its old value.  Returns
+		//! false if there's nothing to undo.
+		bool Undo();
+
+		//! Repeat the most recently undone edit.  Returns false if there's nothing to redo.
+		bool Redo();
+
+		size_t GetUndoCount() const { return m_position; }
+		size_t GetRedoCount() const { return m_edits.size() - m_position; }
+
+		//! Make the next edit a separate step, even if it's of the same property as the last
+		void BreakMerge() { m_isMergeBroken = true; }
+
+		//! Forget every edit
+		void Clear();
+
+		//! Record that the property numbered `index` of `holder` was set from `oldValue` to
+		//! `newValue`, dropping any edits that could be redone.  Called by the holder.
+		template <typename T>
+		void RecordEdit(SimplePropertyHolder& holder,
+		                size_t index,
+		                T&& oldValue,
+		                const std::remove_reference_t<T>& newValue);
+
+	private:
+		friend class SimplePropertyHolder;
+
+		//! How to copy, restore, and destroy values of one type
+		struct ValueOps {
+			size_t size;
+			size_t alignment;
+			//! Assign the value at `value` to `target`, which may hold another type
+			void (*assignAny)(boost::any& target, const void* value);
+			//! Assign the value at `value` over the value at `target`
+			void (*assign)(void* target, const void* value);
+			//! nullptr for trivially destructible types
+			void (*destroy)(void* value);
+		};
+
+		template <typename T> static const ValueOps valueOps;
+
+		struct Edit {
+			SimplePropertyHolder* holder;
+			size_t index;
+			const ValueOps* ops;
+			//! Offset of the old value in the buffer.  The new value follows it.
+			size_t offset;
+
+			size_t getEnd() const { return offset + 2 * ops->size; }
+		};
+
+		std::byte* getOldValue(const Edit& edit) { return m_buffer.data() + edit.offset; }
+		std::byte* getNewValue(const Edit& edit) { return getOldValue(edit) + edit.ops->size; }
+
+		//! Whether the next edit of the given property should be merged into the last one
+		bool shouldMerge(const SimplePropertyHolder& holder, size_t index, const ValueOps& ops);
+
+		//! Drop redoable edits, then find room for a new edit's values, dropping the oldest edits
+		//! as needed.  Returns nullptr if the values are larger than the whole buffer, in which
+		//! case the history is cleared.
+		std::byte* allocate(const ValueOps& ops);
+		//! Set the property changed by `edit` to `value`, one of its values
+		void restore(const Edit& edit, const std::byte* value);
+		void destroy(const Edit& edit);
+		void dropRedo();
+
+		void attach(SimplePropertyHolder& holder);
+		//! Forget `holder` and its edits
+		void detach(SimplePropertyHolder& holder);
+		//! Replace the attached holder `from` with `to`, which it was moved into, keeping its
+		//! edits
+		void moveHolder(SimplePropertyHolder& from, SimplePropertyHolder& to);
+
+		//! Allocated with operator new, so aligned for any type that isn't over-aligned
+		vector<std::byte> m_buffer;
+		//! Oldest first.  The offsets of edits increase until they wrap around to the start of
+		//! the buffer.
+		std::deque<Edit> m_edits;
+		//! Edits before this are undoable, and edits from it on are redoable
+		size_t m_position = 0;
+		bool m_isMergeBroken = true;
+		//! Set while Undo or Redo sets a property
+		bool m_isRestoring = false;
+		vector<SimplePropertyHolder*> m_holders;
+	};
+
+	template <typename T>
+	const PropertyUndoHistory::ValueOps PropertyUndoHistory::valueOps = {
+	    sizeof(T),
+	    alignof(T),
+	    [](boost::any& target, const void* value) {
+		    if (auto* existing = boost::any_cast<T>(&target)) {
+			    *existing = *static_cast<const T*>(value);
+		    } else {
+			    target = *static_cast<const T*>(value);
+		    }
+	    },
+	    [](void* target, const void* value) {
+		    if constexpr (std::is_trivially_copyable_v<T>) {
+			    std::memcpy(target, value, sizeof(T));
+		    } else {
+			    *static_cast<T*>(target) = *static_cast<const T*>(value);
+		    }
+	    },
+	    std::is_trivially_destructible_v<T> ? nullptr
+	                                        : +[](void* value) { static_cast<T*>(value)->~T(); }};
+
+	template <typename T>
+	void PropertyUndoHistory::RecordEdit(SimplePropertyHolder& holder,
+	                                     size_t index,
+	                                     T&& oldValue,
+	                                     const std::remove_reference_t<T>& newValue) {
+		using Value = std::remove_cv_t<std::remove_reference_t<T>>;
+		static_assert(alignof(Value) <= alignof(std::max_align_t),
+		              "Over-aligned property types can't be recorded.");
+		if (m_isRestoring) {
+			return;
+		}
+		const auto& ops = valueOps<Value>;
+		if (shouldMerge(holder, index, ops)) {
+			ops.assign(getNewValue(m_edits.back()), &newValue);
+			return;
+		}
+
+		auto* storage = allocate(ops);
+		if (!storage) {
+			return;
+		}
+		if constexpr (std::is_trivially_copyable_v<Value>) {
+			std::memcpy(storage, &oldValue, sizeof(Value));
+			std::memcpy(storage + sizeof(Value), &newValue, sizeof(Value));
+		} else {
+			new (storage) Value(std::forward<T>(oldValue));
+			new (storage + sizeof(Value)) Value(newValue);
+		}
+		const auto offset = static_cast<size_t>(storage - m_buffer.data());
+		m_edits.push_back(Edit{&holder, index, &ops, offset});
+		m_position = m_edits.size();
+		m_isMergeBroken = false;
+	}
+}
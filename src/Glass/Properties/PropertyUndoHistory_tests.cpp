@@ -0,0 +1,262 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/PropertyUndoHistory.h"
+#include "Glass/Properties/SimplePropertyHolder.h"
+#include "Glass/Properties/Types/Builtins.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+namespace {
+	using Glass::PropertyUndoHistory;
+	using Glass::SimplePropertyHolder;
+
+	//! Counts live instances, to check that the history destroys the values it keeps
+	struct Counted {
+		Counted(std::string value = {})
+		    : value{std::move(value)} {
+			++liveCount;
+		}
+		Counted(const Counted& other)
+		    : value{other.value} {
+			++liveCount;
+		}
+		Counted(Counted&& other)
+		    : value{std::move(other.value)} {
+			++liveCount;
+		}
+		Counted& operator=(const Counted&) = default;
+		Counted& operator=(Counted&&) = default;
+		~Counted() { --liveCount; }
+
+		std::string value;
+		static inline int liveCount = 0;
+	};
+
+	class PropertyUndoHistoryTests : public ::testing::Test {
+	public:
+		void SetUp() override {
+			holder.CreateProperty("Int", Glass::IntPropertyType::name, int32_t{0});
+			holder.CreateProperty("Text", "Counted", Counted{"a"});
+			holder.SetUndoHistory(&history);
+		}
+
+		int32_t getInt() const { return *holder.GetProperty<int32_t>("Int"); }
+		std::string getText() const { return holder.GetPropertyPointer<Counted>("Text")->value; }
+
+		PropertyUndoHistory history;
+		SimplePropertyHolder holder;
+	};
+
+	TEST_F(PropertyUndoHistoryTests, UndoRedo) {
+		ASSERT_FALSE(history.Undo());
+		holder.SetProperty("Int", int32_t{1});
+		history.BreakMerge();
+		holder.SetProperty("Int", int32_t{2});
+		ASSERT_EQ(2u, history.GetUndoCount());
+
+		ASSERT_TRUE(history.Undo());
+		ASSERT_EQ(1, getInt());
+		ASSERT_TRUE(history.Undo());
+		ASSERT_EQ(0, getInt());
+		ASSERT_FALSE(history.Undo());
+		ASSERT_EQ(2u, history.GetRedoCount());
+
+		ASSERT_TRUE(history.Redo());
+		ASSERT_EQ(1, getInt());
+		ASSERT_TRUE(history.Redo());
+		ASSERT_EQ(2, getInt());
+		ASSERT_FALSE(history.Redo());
+	}
+
+	TEST_F(PropertyUndoHistoryTests, ConsecutiveEditsMerge) {
+		for (int32_t i = 1; i <= 10; ++i) {
+			holder.SetProperty("Int", i);
+		}
+		holder.SetProperty("Text", Counted{"b"});
+		holder.SetProperty("Text", Counted{"c"});
+		ASSERT_EQ(2u, history.GetUndoCount());
+
+		ASSERT_TRUE(history.Undo());
+		ASSERT_EQ(std::string{"a"}, getText());
+		ASSERT_TRUE(history.Undo());
+		ASSERT_EQ(0, getInt());
+		ASSERT_TRUE(history.Redo());
+		ASSERT_EQ(10, getInt());
+	}
+
+	TEST_F(PropertyUndoHistoryTests, EditAfterUndoDropsRedo) {
+		holder.SetProperty("Int", int32_t{1});
+		history.BreakMerge();
+		holder.SetProperty("Int", int32_t{2});
+		ASSERT_TRUE(history.Undo());
+		holder.SetProperty("Int", int32_t{3});
+		ASSERT_EQ(0u, history.GetRedoCount());
+		// The new edit isn't merged into the edit before the undone one
+		ASSERT_EQ(2u, history.GetUndoCount());
+		ASSERT_TRUE(history.Undo());
+		ASSERT_EQ(1, getInt());
+	}
+
+	TEST_F(PropertyUndoHistoryTests, ModifyPropertyIsRecorded) {
+		holder.ModifyProperty<Counted>("Text", [](Counted& text) { text.value += "bc"; });
+		ASSERT_EQ(std::string{"abc"}, getText());
+		ASSERT_TRUE(history.Undo());
+		ASSERT_EQ(std::string{"a"}, getText());
+		ASSERT_TRUE(history.Redo());
+		ASSERT_EQ(std::string{"abc"}, getText());
+	}
+
+	TEST_F(PropertyUndoHistoryTests, UndoFiresSignalAndMarksDirty) {
+		holder.SetProperty("Int", int32_t{1});
+		ASSERT_TRUE(holder.ConsumeDirty(0));
+		int signalCount = 0;
+		Trackable trackable;
+		holder.GetPropertySignal("Int").Connect(&trackable, [&] {
+			++signalCount;
+			// Follow-on edits made by handlers aren't recorded
+			holder.SetProperty("Text", Counted{"changed"});
+		});
+		ASSERT_TRUE(history.Undo());
+		ASSERT_EQ(1, signalCount);
+		ASSERT_TRUE(holder.ConsumeDirty(0));
+		ASSERT_EQ(1u, history.GetRedoCount());
+		ASSERT_EQ(0u, history.GetUndoCount());
+	}
+
+	TEST(PropertyUndoHistory, OldestEditsAreDropped) {
+		// Room for four edits of an int
+		PropertyUndoHistory history{4 * 2 * sizeof(int32_t)};
+		SimplePropertyHolder holder;
+		holder.CreateProperty("Int", Glass::IntPropertyType::name, int32_t{0});
+		holder.SetUndoHistory(&history);
+		for (int32_t i = 1; i <= 10; ++i) {
+			holder.SetProperty("Int", i);
+			history.BreakMerge();
+		}
+		ASSERT_EQ(4u, history.GetUndoCount());
+		while (history.Undo()) {
+		}
+		ASSERT_EQ(6, *holder.GetProperty<int32_t>("Int"));
+		while (history.Redo()) {
+		}
+		ASSERT_EQ(10, *holder.GetProperty<int32_t>("Int"));
+	}
+
+	TEST(PropertyUndoHistory, MixedSizesWrapAround) {
+		PropertyUndoHistory history{256};
+		SimplePropertyHolder holder;
+		holder.CreateProperty("Int", Glass::IntPropertyType::name, int32_t{0});
+		holder.CreateProperty("Text", Glass::StringPropertyType::name, std::string{});
+		holder.SetUndoHistory(&history);
+		for (int32_t i = 1; i <= 100; ++i) {
+			holder.SetProperty("Int", i);
+			holder.SetProperty("Text", std::to_string(i));
+		}
+		const auto keptCount = history.GetUndoCount();
+		ASSERT_LT(0u, keptCount);
+		ASSERT_GT(200u, keptCount);
+
+		// Undoing every kept edit goes back to the values before the oldest kept edit.  Edits
+		// alternate between the properties, so none were merged.
+		while (history.Undo()) {
+		}
+		const auto droppedCount = static_cast<int32_t>(200 - keptCount);
+		ASSERT_EQ((droppedCount + 1) / 2, *holder.GetProperty<int32_t>("Int"));
+		const auto droppedTextCount = droppedCount / 2;
+		ASSERT_EQ(droppedTextCount > 0 ? std::to_string(droppedTextCount) : std::string{},
+		          *holder.GetProperty<std::string>("Text"));
+
+		while (history.Redo()) {
+		}
+		ASSERT_EQ(100, *holder.GetProperty<int32_t>("Int"));
+		ASSERT_EQ(std::string{"100"}, *holder.GetProperty<std::string>("Text"));
+	}
+
+	TEST(PropertyUndoHistory, ValuesAreDestroyed) {
+		{
+			PropertyUndoHistory history{1024};
+			SimplePropertyHolder holder;
+			holder.CreateProperty("Text", "Counted", Counted{});
+			holder.SetUndoHistory(&history);
+			for (int i = 0; i < 100; ++i) {
+				holder.SetProperty("Text", Counted{std::to_string(i)});
+				history.BreakMerge();
+			}
+			history.Undo();
+			history.Undo();
+			holder.SetProperty("Text", Counted{"last"});
+		}
+		ASSERT_EQ(0, Counted::liveCount);
+	}
+
+	TEST(PropertyUndoHistory, DestroyedHoldersAreForgotten) {
+		PropertyUndoHistory history;
+		SimplePropertyHolder kept;
+		kept.CreateProperty("Int", Glass::IntPropertyType::name, int32_t{0});
+		kept.SetUndoHistory(&history);
+		{
+			SimplePropertyHolder destroyed;
+			destroyed.CreateProperty("Int", Glass::IntPropertyType::name, int32_t{0});
+			destroyed.SetUndoHistory(&history);
+			kept.SetProperty("Int", int32_t{1});
+			destroyed.SetProperty("Int", int32_t{2});
+			kept.SetProperty("Int", int32_t{3});
+			ASSERT_EQ(3u, history.GetUndoCount());
+		}
+		ASSERT_EQ(2u, history.GetUndoCount());
+		ASSERT_TRUE(history.Undo());
+		ASSERT_EQ(1, *kept.GetProperty<int32_t>("Int"));
+	}
+
+	TEST(PropertyUndoHistory, HistoryCanBeDestroyedFirst) {
+		SimplePropertyHolder holder;
+		holder.CreateProperty("Int", Glass::IntPropertyType::name, int32_t{0});
+		{
+			PropertyUndoHistory history;
+			holder.SetUndoHistory(&history);
+			holder.SetProperty("Int", int32_t{1});
+		}
+		ASSERT_TRUE(holder.SetProperty("Int", int32_t{2}));
+	}
+
+	TEST(PropertyUndoHistory, HistoryMovesWithHolder) {
+		auto history = std::make_unique<PropertyUndoHistory>();
+		SimplePropertyHolder moved;
+		{
+			SimplePropertyHolder holder;
+			holder.CreateProperty("Int", Glass::IntPropertyType::name, int32_t{0});
+			holder.SetUndoHistory(history.get());
+			holder.SetProperty("Int", int32_t{1});
+			moved = SimplePropertyHolder{std::move(holder)};
+		}
+		// The edit made through the moved from holder is undone on the one it moved into
+		ASSERT_EQ(1u, history->GetUndoCount());
+		ASSERT_TRUE(history->Undo());
+		ASSERT_EQ(0, *moved.GetProperty<int32_t>("Int"));
+		history->BreakMerge();
+		moved.SetProperty("Int", int32_t{2});
+		ASSERT_EQ(1u, history->GetUndoCount());
+
+		// Destroying the history detaches the holder it moved to
+		history.reset();
+		ASSERT_TRUE(moved.SetProperty("Int", int32_t{3}));
+	}
+}
@@ -23,11 +23,9 @@
 
 #define GLASS_REGISTER_PROPERTY_TYPE(Type)                                                                  \
 	namespace {                                                                                             \
-		[[maybe_unused]] const void* g_PropertyRegistrationData##Type =                                     \
-		    reinterpret_cast<const void*>(&Glass::Private::RegisterPropertyType<Type>::staticRegistration);                                       \
 		using PropertyRegistrationType_Optional##Type = Glass::OptionalProperty<Type>;                      \
-		[[maybe_unused]] const void* g_PropertyRegistrationDataOptional##Type =                             \
-		    reinterpret_cast<const void*>(&Glass::Private::RegisterPropertyType<PropertyRegistrationType_Optional##Type>::staticRegistration);    \
+		[[maybe_unused]] const void* g_PropertyRegistrationData##Type =                                     \
+		    reinterpret_cast<const void*>(&Glass::Private::RegisterPropertyType<Type, PropertyRegistrationType_Optional##Type>::staticRegistration);    \
 	}
 
 // clang-format on
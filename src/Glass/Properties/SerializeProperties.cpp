@@ -0,0 +1,45 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/SerializeProperties.h"
+
+#include <string_view>
+#include <unordered_map>
+
+void Glass::MergeSerializedProperties(SerializedProperties& base, SerializedProperties changes) {
+	if (changes.empty()) {
+		return;
+	}
+	// Reserve first, so the names viewed by positions don't move when changes are appended
+	base.reserve(base.size() + changes.size());
+	std::unordered_map<std::string_view, size_t> positions;
+	positions.reserve(base.size());
+	for (size_t i = 0; i < base.size(); ++i) {
+		positions.emplace(base[i].name, i);
+	}
+
+	for (auto& change : changes) {
+		const auto it = positions.find(change.name);
+		if (it != positions.end()) {
+			base[it->second].value = std::move(change.value);
+		} else {
+			base.push_back(std::move(change));
+			positions.emplace(base.back().name, base.size() - 1);
+		}
+	}
+}
@@ -0,0 +1,170 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include "Glass/Properties/HasProperties.h"
+#include "Glass/Properties/Private/GlobalPropertyData.h"
+#include "Glass/Properties/Private/getName.h"
+#include "Glass/Properties/PropertyList.h"
+
+namespace Glass {
+	//! A property name and its serialized value
+	struct SerializedProperty {
+		std::string name;
+		std::string value;
+	};
+
+	using SerializedProperties = vector<SerializedProperty>;
+
+	namespace Private {
+		//! Computed properties aren't serialized, since they are recomputed from their inputs
+		template <typename P, typename U, typename Ps>
+		void serializeProperty(const HasProperties<U, Ps>& object, SerializedProperties& out) {
+			if constexpr (Meta::IsComputedProperty<P>) {
+				UNREF_PARAM(object);
+				UNREF_PARAM(out);
+			} else {
+				using PropertyType = typename P::property_type;
+				using Data = GlobalPropertyData::TypedPropertyTypeSerializationData<PropertyType>;
+				const auto& data =
+				    GlobalPropertyData::GetTypedPropertyTypeSerializationData<PropertyType>();
+				const auto* scratchSpace = boost::any_cast<typename Data::scratch_type>(
+				    &object.template GetPropertyScratchSpace<P>());
+				auto serialized =
+				    data.serialize(object.template GetPropertyRef<P>(), scratchSpace);
+				if (serialized) {
+					out.push_back(SerializedProperty{getName<P>(), std::move(*serialized)});
+				}
+			}
+		}
+
+		//! Computed properties can't be set, so their serialized values are ignored
+		template <typename P, typename U, typename Ps>
+		void deserializeProperty(HasProperties<U, Ps>& object, const SerializedProperty& property) {
+			if constexpr (Meta::IsComputedProperty<P>) {
+				UNREF_PARAM(object);
+				UNREF_PARAM(property);
+			} else {
+				using PropertyType = typename P::property_type;
+				const auto& data =
+				    GlobalPropertyData::GetTypedPropertyTypeSerializationData<PropertyType>();
+				if (auto deserialized = data.deserialize(property.value, nullptr)) {
+					boost::any scratchSpace;
+					if (deserialized->scratchSpace) {
+						scratchSpace = std::move(*deserialized->scratchSpace);
+					}
+					object.template SetPropertyAndScratchSpace<P>(std::move(deserialized->value),
+					                                              std::move(scratchSpace));
+				} else {
+					ZERROR("Failed to deserialize property.");
+				}
+			}
+		}
+
+		template <typename U, typename Ps, typename... P>
+		void serializeProperties(const HasProperties<U, Ps>& object,
+		                         SerializedProperties& out,
+		                         PropertyList<P...>) {
+			(serializeProperty<P>(object, out), ...);
+		}
+
+		template <typename U, typename Ps, typename... P>
+		void serializeChangedProperties(const HasProperties<U, Ps>& object,
+		                                uint64_t version,
+		                                SerializedProperties& out,
+		                                PropertyList<P...>) {
+			if constexpr (sizeof...(P) > 0) {
+				// Indexed by the position of each property in Ps
+				using SerializeFn = void (*)(const HasProperties<U, Ps>&, SerializedProperties&);
+				static constexpr SerializeFn serializers[] = {&serializeProperty<P, U, Ps>...};
+				const auto changed = object.template GetChangedSince<Ps>(version);
+				for (size_t i = 0; i < changed.size(); ++i) {
+					if (changed[i]) {
+						serializers[i](object, out);
+					}
+				}
+			} else {
+				UNREF_PARAM(object);
+				UNREF_PARAM(version);
+				UNREF_PARAM(out);
+			}
+		}
+
+		template <typename U, typename Ps, typename... P>
+		void deserializeProperties(HasProperties<U, Ps>& object,
+		                           const SerializedProperties& properties,
+		                           PropertyList<P...>) {
+			if constexpr (sizeof...(P) > 0) {
+				// Indexed by the position of each property in Ps
+				using DeserializeFn = void (*)(HasProperties<U, Ps>&, const SerializedProperty&);
+				static constexpr DeserializeFn deserializers[] = {
+				    &deserializeProperty<P, U, Ps>...};
+				for (const auto& property : properties) {
+					if (const auto index = PropertyListIndex<Ps>::Find(property.name)) {
+						deserializers[*index](object, property);
+					}
+				}
+			} else {
+				UNREF_PARAM(object);
+				UNREF_PARAM(properties);
+			}
+		}
+	}
+
+	//! Serialize every property in the PropertyList Ps of `object`, in PropertyList order.
+	//!
+	//! The property types are known statically, so this calls each type's serializer directly
+	//! rather than going through the type erased global property data.  Properties that fail to
+	//! serialize are left out, as are computed properties.
+	template <typename Ps, typename U> SerializedProperties SerializeProperties(const U& object) {
+		const HasProperties<U, Ps>& hasProperties = object;
+		SerializedProperties serializedProperties;
+		serializedProperties.reserve(PropertyListSize<Ps>);
+		Private::serializeProperties(hasProperties, serializedProperties, Ps{});
+		return serializedProperties;
+	}
+
+	//! Serialize the properties in the PropertyList Ps of `object` that were set after
+	//! `version`, a value previously returned by its GetPropertiesVersion, in PropertyList order.
+	//!
+	//! This is for checkpointing large documents: keep the output of SerializeProperties along
+	//! with the version it was taken at, and later bring it up to date by merging the changed
+	//! properties over it with MergeSerializedProperties.  Only the changed properties are
+	//! serialized.
+	template <typename Ps, typename U>
+	SerializedProperties SerializeChangedProperties(const U& object, uint64_t version) {
+		const HasProperties<U, Ps>& hasProperties = object;
+		SerializedProperties serializedProperties;
+		Private::serializeChangedProperties(hasProperties, version, serializedProperties, Ps{});
+		return serializedProperties;
+	}
+
+	//! Apply `changes`, such as the output of SerializeChangedProperties, over `base`.  Each
+	//! change replaces the value of the property with the same name in `base`, keeping its
+	//! position, and changes to properties that aren't in `base` are appended.  If a name
+	//! appears more than once in `changes` the last value wins.
+	void MergeSerializedProperties(SerializedProperties& base, SerializedProperties changes);
+
+	//! Set the properties in the PropertyList Ps of `object` from `properties`.  Names that aren't
+	//! in Ps are ignored, as are computed properties.  Types that need a deserialization context
+	//! are given a nullptr context.
+	//! Each name is looked up with the PropertyListIndex of Ps.
+	template <typename Ps, typename U>
+	void DeserializeProperties(U& object, const SerializedProperties& properties) {
+		HasProperties<U, Ps>& hasProperties = object;
+		Private::deserializeProperties(hasProperties, properties, Ps{});
+	}
+}
@@ -0,0 +1,230 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/HasProperties.h"
+#include "Glass/Properties/HasPropertiesBase.h"
+#include "Glass/Properties/SerializeProperties.h"
+#include "Glass/Properties/Types/Builtins.h"
+#include "Glass/Properties/Types/ScratchSpaceAndValue.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+namespace {
+	struct IntValue : Glass::PropertyDefinition<IntValue, Glass::IntPropertyType> {
+		static constexpr const char* const name = "IntValue";
+		static constexpr Glass::IntPropertyType::type defaultValue = 65;
+	};
+
+	struct FloatValue : Glass::PropertyDefinition<FloatValue, Glass::FloatPropertyType> {
+		static constexpr const char* const name = "FloatValue";
+		static constexpr Glass::FloatPropertyType::type defaultValue = 42.f;
+	};
+
+	struct Title : Glass::PropertyDefinition<Title, Glass::StringPropertyType> {
+		static constexpr const char* const name = "Title";
+		static std::string defaultValue() { return "hello, world"; }
+	};
+
+	//! An int that keeps the text it was deserialized from as scratch space, so that it is
+	//! serialized the same way as long as the value doesn't change
+	struct PaddedIntPropertyType : Glass::PropertyType<int32_t> {
+		static constexpr auto name = "PaddedInt";
+		using scratch_type = std::string;
+		static std::optional<std::string> serialize(int32_t value, const std::string* scratch) {
+			if (scratch && std::stoi(*scratch) == value) {
+				return *scratch;
+			}
+			return std::to_string(value);
+		}
+		static std::optional<Glass::ScratchSpaceAndValue<scratch_type, type>>
+		deserialize(const std::string& serializedValue) {
+			if (serializedValue.empty() ||
+			    serializedValue.find_first_not_of("0123456789") != std::string::npos) {
+				return std::nullopt;
+			}
+			return Glass::ScratchSpaceAndValue<scratch_type, type>{serializedValue,
+			                                                       std::stoi(serializedValue)};
+		}
+	};
+
+	struct PaddedValue : Glass::PropertyDefinition<PaddedValue, PaddedIntPropertyType> {
+		static constexpr const char* const name = "PaddedValue";
+		static constexpr int32_t defaultValue = 0;
+	};
+
+	//! An int that counts its copies
+	struct CountedInt {
+		explicit CountedInt(int32_t value)
+		    : value{value} {}
+		CountedInt(const CountedInt& other)
+		    : value{other.value} {
+			++copies;
+		}
+		CountedInt& operator=(const CountedInt& other) {
+			value = other.value;
+			++copies;
+			return *this;
+		}
+
+		int32_t value;
+		static inline size_t copies = 0;
+	};
+
+	struct CountedIntPropertyType : Glass::PropertyType<CountedInt> {
+		static constexpr auto name = "CountedInt";
+		static std::string serialize(const CountedInt& value) {
+			return std::to_string(value.value);
+		}
+		static std::optional<CountedInt> deserialize(const std::string& serializedValue) {
+			return CountedInt{std::stoi(serializedValue)};
+		}
+	};
+
+	struct CountedValue : Glass::PropertyDefinition<CountedValue, CountedIntPropertyType> {
+		static constexpr const char* const name = "CountedValue";
+		static CountedInt defaultValue() { return CountedInt{3}; }
+	};
+
+	using Properties = Glass::PropertyList<IntValue, FloatValue>;
+	using OtherProperties = Glass::PropertyList<Title>;
+
+	struct TestClass : public Glass::HasPropertiesBase,
+	                   public Glass::HasProperties<TestClass, Properties>,
+	                   public Glass::HasProperties<TestClass, OtherProperties> {
+		using Glass::HasProperties<TestClass, Properties>::GetProperty;
+		using Glass::HasProperties<TestClass, OtherProperties>::GetProperty;
+		using Glass::HasProperties<TestClass, Properties>::SetProperty;
+		using Glass::HasProperties<TestClass, OtherProperties>::SetProperty;
+	};
+
+	using PaddedProperties = Glass::PropertyList<PaddedValue>;
+
+	struct PaddedClass : public Glass::HasPropertiesBase,
+	                     public Glass::HasProperties<PaddedClass, PaddedProperties> {};
+
+	using CountedProperties = Glass::PropertyList<CountedValue>;
+
+	struct CountedClass : public Glass::HasPropertiesBase,
+	                      public Glass::HasProperties<CountedClass, CountedProperties> {};
+}
+
+TEST(SerializeProperties, SerializesInPropertyListOrder) {
+	TestClass object;
+	const auto serialized = Glass::SerializeProperties<Properties>(object);
+	ASSERT_EQ(2u, serialized.size());
+	ASSERT_EQ(std::string{"IntValue"}, serialized[0].name);
+	ASSERT_EQ(std::string{"65"}, serialized[0].value);
+	ASSERT_EQ(std::string{"FloatValue"}, serialized[1].name);
+	ASSERT_EQ(std::string{"42"}, serialized[1].value);
+}
+
+TEST(SerializeProperties, OnlySerializesGivenList) {
+	TestClass object;
+	const auto serialized = Glass::SerializeProperties<OtherProperties>(object);
+	ASSERT_EQ(1u, serialized.size());
+	ASSERT_EQ(std::string{"Title"}, serialized[0].name);
+	ASSERT_EQ(std::string{"hello, world"}, serialized[0].value);
+}
+
+TEST(SerializeProperties, RoundTrip) {
+	TestClass source;
+	source.SetProperty<IntValue>(-5);
+	source.SetProperty<FloatValue>(2.5f);
+
+	TestClass destination;
+	Glass::DeserializeProperties<Properties>(destination,
+	                                         Glass::SerializeProperties<Properties>(source));
+	ASSERT_EQ(-5, destination.GetProperty<IntValue>());
+	ASSERT_EQ(2.5f, destination.GetProperty<FloatValue>());
+}
+
+TEST(SerializeProperties, KeepsScratchSpace) {
+	PaddedClass object;
+	Glass::DeserializeProperties<PaddedProperties>(object, {{"PaddedValue", "007"}});
+	ASSERT_EQ(7, object.GetProperty<PaddedValue>());
+	ASSERT_EQ(std::string{"007"},
+	          Glass::SerializeProperties<PaddedProperties>(object)[0].value);
+
+	object.SetProperty<PaddedValue>(8);
+	ASSERT_EQ(std::string{"8"}, Glass::SerializeProperties<PaddedProperties>(object)[0].value);
+}
+
+TEST(SerializeProperties, SerializeDoesntCopyValues) {
+	CountedClass object;
+	CountedInt::copies = 0;
+	const auto serialized = Glass::SerializeProperties<CountedProperties>(object);
+	ASSERT_EQ(std::string{"3"}, serialized[0].value);
+	ASSERT_EQ(0u, CountedInt::copies);
+}
+
+TEST(SerializeProperties, DeserializeIgnoresUnknownNames) {
+	TestClass object;
+	Glass::DeserializeProperties<Properties>(
+	    object, Glass::SerializedProperties{{"Title", "goodbye"}, {"IntValue", "3"}});
+	ASSERT_EQ(3, object.GetProperty<IntValue>());
+	ASSERT_EQ(std::string{"hello, world"}, object.GetProperty<Title>());
+}
+
+TEST(SerializeProperties, SerializeChangedProperties) {
+	TestClass object;
+	const auto checkpoint = object.GetPropertiesVersion();
+	ASSERT_TRUE(Glass::SerializeChangedProperties<Properties>(object, checkpoint).empty());
+
+	object.SetProperty<FloatValue>(2.5f);
+	object.SetProperty<Title>(std::string{"goodbye"});
+	const auto serialized = Glass::SerializeChangedProperties<Properties>(object, checkpoint);
+	ASSERT_EQ(1u, serialized.size());
+	ASSERT_EQ(std::string{"FloatValue"}, serialized[0].name);
+	ASSERT_EQ(Glass::SerializeProperties<Properties>(object)[1].value, serialized[0].value);
+
+	// Changes before the checkpoint are left out
+	const auto nextCheckpoint = object.GetPropertiesVersion();
+	object.SetProperty<IntValue>(3);
+	const auto next = Glass::SerializeChangedProperties<Properties>(object, nextCheckpoint);
+	ASSERT_EQ(1u, next.size());
+	ASSERT_EQ(std::string{"IntValue"}, next[0].name);
+	ASSERT_EQ(2u, Glass::SerializeChangedProperties<Properties>(object, checkpoint).size());
+}
+
+TEST(SerializeProperties, MergeChangesMatchesFullSerialization) {
+	TestClass object;
+	auto document = Glass::SerializeProperties<Properties>(object);
+	const auto checkpoint = object.GetPropertiesVersion();
+
+	object.SetProperty<FloatValue>(-1.f);
+	Glass::MergeSerializedProperties(
+	    document, Glass::SerializeChangedProperties<Properties>(object, checkpoint));
+	const auto expected = Glass::SerializeProperties<Properties>(object);
+	ASSERT_EQ(expected.size(), document.size());
+	for (size_t i = 0; i < expected.size(); ++i) {
+		ASSERT_EQ(expected[i].name, document[i].name);
+		ASSERT_EQ(expected[i].value, document[i].value);
+	}
+}
+
+TEST(SerializeProperties, MergeAppendsNewNames) {
+	Glass::SerializedProperties document{{"IntValue", "1"}, {"FloatValue", "2"}};
+	Glass::MergeSerializedProperties(
+	    document, Glass::SerializedProperties{{"Title", "a"}, {"IntValue", "3"}, {"Title", "b"}});
+	ASSERT_EQ(3u, document.size());
+	ASSERT_EQ(std::string{"3"}, document[0].value);
+	ASSERT_EQ(std::string{"2"}, document[1].value);
+	ASSERT_EQ(std::string{"Title"}, document[2].name);
+	ASSERT_EQ(std::string{"b"}, document[2].value);
+}
@@ -17,13 +17,50 @@
 
 #include "Glass/Properties/SimplePropertyHolder.h"
 
+#include <utility>
+
+#include "Glass/Properties/Private/GlobalPropertyData.h"
+#include "Glass/Properties/Types/BinaryCodec.h"
+
+namespace {
+	//! How EncodeProperty wrote a value
+	enum class PropertyEncoding : uint8_t {
+		BinaryCodec,
+		Serializer,
+	};
+}
+
+Glass::SimplePropertyHolder::SimplePropertyHolder(SimplePropertyHolder&& other) noexcept
+    : m_propertyValues{std::move(other.m_propertyValues)}
+    , m_isDirty{std::move(other.m_isDirty)}
+    , m_propertyVersions{std::move(other.m_propertyVersions)}
+    , m_propertiesByIndex{std::move(other.m_propertiesByIndex)}
+    , m_version{other.m_version} {
+	takeUndoHistory(other);
+}
+
+Glass::SimplePropertyHolder&
+Glass::SimplePropertyHolder::operator=(SimplePropertyHolder&& other) noexcept {
+	if (this != &other) {
+		SetUndoHistory(nullptr);
+		m_propertyValues = std::move(other.m_propertyValues);
+		m_isDirty = std::move(other.m_isDirty);
+		m_propertyVersions = std::move(other.m_propertyVersions);
+		m_propertiesByIndex = std::move(other.m_propertiesByIndex);
+		m_version = other.m_version;
+		takeUndoHistory(other);
+	}
+	return *this;
+}
+
+Glass::SimplePropertyHolder::~SimplePropertyHolder() {
+	SetUndoHistory(nullptr);
+}
+
 bool Glass::SimplePropertyHolder::CreateProperty(std::string_view name,
                                                  std::string_view typeName,
                                                  boost::any value,
                                                  boost::any scratchSpace) {
-	UNREF_PARAM(typeName);
-	UNREF_PARAM(scratchSpace);
-
 	auto it = std::find_if(m_propertyValues.cbegin(), m_propertyValues.cend(), [&](const auto& e) {
 		return std::string_view{e.first} == name;
 	});
@@ -31,10 +68,295 @@ bool Glass::SimplePropertyHolder::CreateProperty(std::string_view name,
 		return false;
 	}
 
-	m_propertyValues.emplace(std::string{name}, PropertyValue{std::move(value)});
+	const auto inserted = m_propertyValues
+	                          .emplace(std::string{name},
+	                                   PropertyValue{std::string{typeName},
+	                                                 std::move(value),
+	                                                 std::move(scratchSpace),
+	                                                 m_isDirty.size()})
+	                          .first;
+	m_isDirty.push_back(false);
+	m_propertyVersions.push_back(0);
+	m_propertiesByIndex.push_back(&inserted->second);
+	return true;
+}
+
+const boost::any* Glass::SimplePropertyHolder::GetPropertyScratchSpace(
+    std::string_view name) const {
+	const auto it = m_propertyValues.find(std::string{name});
+	return it != m_propertyValues.end() ? &it->second.scratchSpace : nullptr;
+}
+
+std::optional<std::string>
+Glass::SimplePropertyHolder::SerializeProperty(std::string_view name) const {
+	const auto it = m_propertyValues.find(std::string{name});
+	if (it == m_propertyValues.end()) {
+		return std::nullopt;
+	}
+	const auto& property = it->second;
+	const auto* registration =
+	    Private::GlobalPropertyData::findPropertyTypeRegistration(property.typeName);
+	if (!registration || !registration->serialize) {
+		return std::nullopt;
+	}
+	return registration->serialize(property.value, property.scratchSpace);
+}
+
+bool Glass::SimplePropertyHolder::DeserializeProperty(std::string_view name,
+                                                      const std::string& serializedValue,
+                                                      const boost::any& context) {
+	const auto it = m_propertyValues.find(std::string{name});
+	if (it == m_propertyValues.end()) {
+		return false;
+	}
+	auto& property = it->second;
+	const auto* registration =
+	    Private::GlobalPropertyData::findPropertyTypeRegistration(property.typeName);
+	if (!registration || !registration->deserializeInto ||
+	    !registration->deserializeInto(
+	        serializedValue, context, property.value, property.scratchSpace)) {
+		return false;
+	}
+	didChange(property);
 	return true;
 }
 
 Signal<>& Glass::SimplePropertyHolder::GetPropertySignal(std::string_view name) {
 	return m_propertyValues.at(std::string{name}).signal;
 }
+
+std::optional<size_t>
+Glass::SimplePropertyHolder::FindPropertyIndex(std::string_view name) const {
+	const auto it = m_propertyValues.find(std::string{name});
+	if (it == m_propertyValues.end()) {
+		return std::nullopt;
+	}
+	return it->second.index;
+}
+
+vector<std::string_view> Glass::SimplePropertyHolder::GetPropertyTypeNames() const {
+	vector<std::string_view> typeNames;
+	typeNames.reserve(m_propertyValues.size());
+	for (const auto& entry : m_propertyValues) {
+		typeNames.emplace_back(entry.second.typeName);
+	}
+	return typeNames;
+}
+
+void Glass::SimplePropertyHolder::SerializeBinary(BinaryWriter& writer) const {
+	struct BinaryProperty {
+		const std::string* name;
+		const PropertyValue* property;
+		const Private::GlobalPropertyData::PropertyBinaryCodec* codec;
+	};
+	vector<BinaryProperty> properties;
+	properties.reserve(m_propertyValues.size());
+	for (const auto& [name, property] : m_propertyValues) {
+		if (const auto* codec =
+		        Private::GlobalPropertyData::getPropertyBinaryCodec(property.typeName)) {
+			properties.push_back(BinaryProperty{&name, &property, codec});
+		}
+	}
+	std::sort(properties.begin(), properties.end(), [](const auto& lhs, const auto& rhs) {
+		return *lhs.name < *rhs.name;
+	});
+
+	const auto countOffset = writer.GetSize();
+	writer.WriteSize(0);
+	size_t count = 0;
+	for (const auto& p : properties) {
+		const auto propertyOffset = writer.GetSize();
+		writer.WriteString(*p.name);
+		writer.WriteString(p.property->typeName);
+		// Each value is length prefixed so that readers can skip properties they don't know
+		const auto sizeOffset = writer.GetSize();
+		writer.WriteSize(0);
+		if (!p.codec->serialize(p.property->value, writer)) {
+			writer.Truncate(propertyOffset);
+			continue;
+		}
+		writer.PatchSize(sizeOffset, writer.GetSize() - sizeOffset - sizeof(uint32_t));
+		++count;
+	}
+	writer.PatchSize(countOffset, count);
+}
+
+bool Glass::SimplePropertyHolder::DeserializeBinary(BinaryReader& reader) {
+	const auto count = reader.ReadSize();
+	if (!count) {
+		return false;
+	}
+	for (size_t i = 0; i < *count; ++i) {
+		const auto name = reader.ReadStringView();
+		const auto typeName = reader.ReadStringView();
+		const auto valueSize = reader.ReadSize();
+		if (!name || !typeName || !valueSize) {
+			return false;
+		}
+		auto valueReader = reader.ReadSubReader(*valueSize);
+		if (!valueReader) {
+			return false;
+		}
+
+		auto it = m_propertyValues.find(std::string{*name});
+		if (it == m_propertyValues.end() || it->second.typeName != *typeName) {
+			continue;
+		}
+		const auto* codec =
+		    Private::GlobalPropertyData::getPropertyBinaryCodec(it->second.typeName);
+		if (!codec) {
+			continue;
+		}
+		auto value = codec->deserialize(*valueReader);
+		if (!value || !valueReader->IsAtEnd()) {
+			ZERROR("Failed to decode binary property value.");
+			continue;
+		}
+		it->second.value = std::move(*value);
+		didChange(it->second);
+	}
+	return true;
+}
+
+bool Glass::SimplePropertyHolder::ConsumeDirty(size_t index) {
+	ZASSERT(index < m_isDirty.size());
+	const bool isDirty = m_isDirty[index];
+	m_isDirty[index] = false;
+	return isDirty;
+}
+
+void Glass::SimplePropertyHolder::FirePropertySignal(size_t index) {
+	ZASSERT(index < m_propertiesByIndex.size());
+	m_propertiesByIndex[index]->signal();
+}
+
+void Glass::SimplePropertyHolder::markChanged(PropertyValue& property) {
+	m_isDirty[property.index] = true;
+	m_propertyVersions[property.index] = ++m_version;
+}
+
+void Glass::SimplePropertyHolder::didChange(PropertyValue& property) {
+	markChanged(property);
+	property.signal();
+}
+
+bool Glass::SimplePropertyHolder::EncodeProperty(size_t index, BinaryWriter& writer) const {
+	ZASSERT(index < m_propertiesByIndex.size());
+	const auto& property = *m_propertiesByIndex[index];
+	if (const auto* codec =
+	        Private::GlobalPropertyData::getPropertyBinaryCodec(property.typeName)) {
+		writer.Write(PropertyEncoding::BinaryCodec);
+		return codec->serialize(property.value, writer);
+	}
+	const auto* registration =
+	    Private::GlobalPropertyData::findPropertyTypeRegistration(property.typeName);
+	if (!registration || !registration->serialize) {
+		return false;
+	}
+	const auto serialized = registration->serialize(property.value, property.scratchSpace);
+	if (!serialized) {
+		return false;
+	}
+	writer.Write(PropertyEncoding::Serializer);
+	writer.WriteString(*serialized);
+	return true;
+}
+
+bool Glass::SimplePropertyHolder::DecodeProperty(size_t index, BinaryReader& reader) {
+	ZASSERT(index < m_propertiesByIndex.size());
+	auto& property = *m_propertiesByIndex[index];
+	const auto encoding = reader.Read<PropertyEncoding>();
+	if (encoding == PropertyEncoding::BinaryCodec) {
+		const auto* codec = Private::GlobalPropertyData::getPropertyBinaryCodec(property.typeName);
+		if (!codec) {
+			return false;
+		}
+		auto value = codec->deserialize(reader);
+		if (!value || !reader.IsAtEnd()) {
+			return false;
+		}
+		property.value = std::move(*value);
+	} else if (encoding == PropertyEncoding::Serializer) {
+		const auto serialized = reader.ReadString();
+		const auto* registration =
+		    Private::GlobalPropertyData::findPropertyTypeRegistration(property.typeName);
+		if (!serialized || !reader.IsAtEnd() || !registration || !registration->deserializeInto ||
+		    !registration->deserializeInto(
+		        *serialized, boost::any{}, property.value, property.scratchSpace)) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+	didChange(property);
+	return true;
+}
+
+void Glass::SimplePropertyHolder::SetUndoHistory(PropertyUndoHistory* history) {
+	if (m_undoHistory) {
+		m_undoHistory->detach(*this);
+	}
+	m_undoHistory = history;
+	if (m_undoHistory) {
+		m_undoHistory->attach(*this);
+	}
+}
+
+void Glass::SimplePropertyHolder::takeUndoHistory(SimplePropertyHolder& other) {
+	m_undoHistory = std::exchange(other.m_undoHistory, nullptr);
+	if (m_undoHistory) {
+		m_undoHistory->moveHolder(other, *this);
+	}
+}
+
+void Glass::SimplePropertyHolder::restoreProperty(size_t index,
+                                                  void (*assign)(boost::any& target,
+                                                                 const void* value),
+                                                  const void* value) {
+	ZASSERT(index < m_propertiesByIndex.size());
+	auto& property = *m_propertiesByIndex[index];
+	assign(property.value, value);
+	didChange(property);
+}
+
+bool Glass::SimplePropertyHolder::IsPropertyEqual(size_t index,
+                                                  const SimplePropertyHolder& other,
+                                                  size_t otherIndex) const {
+	ZASSERT(index < m_propertiesByIndex.size());
+	ZASSERT(otherIndex < other.m_propertiesByIndex.size());
+	const auto& property = *m_propertiesByIndex[index];
+	const auto& otherProperty = *other.m_propertiesByIndex[otherIndex];
+	if (property.typeName != otherProperty.typeName) {
+		return false;
+	}
+	const auto* registration =
+	    Private::GlobalPropertyData::findPropertyTypeRegistration(property.typeName);
+	if (!registration) {
+		return false;
+	}
+	if (registration->equals) {
+		return registration->equals(property.value, otherProperty.value);
+	}
+	if (!registration->serialize) {
+		return false;
+	}
+	const auto serialized = registration->serialize(property.value, property.scratchSpace);
+	return serialized &&
+	       serialized == registration->serialize(otherProperty.value, otherProperty.scratchSpace);
+}
+
+vector<size_t> Glass::DiffProperties(const SimplePropertyHolder& lhs,
+                                     const SimplePropertyHolder& rhs) {
+	const auto commonCount = std::min(lhs.GetPropertyCount(), rhs.GetPropertyCount());
+	const auto count = std::max(lhs.GetPropertyCount(), rhs.GetPropertyCount());
+	vector<size_t> different;
+	for (size_t i = 0; i < commonCount; ++i) {
+		if (!lhs.IsPropertyEqual(i, rhs, i)) {
+			different.push_back(i);
+		}
+	}
+	for (size_t i = commonCount; i < count; ++i) {
+		different.push_back(i);
+	}
+	return different;
+}
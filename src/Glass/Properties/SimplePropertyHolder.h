@@ -13,14 +13,31 @@
 // limitations under the License.
 
 
+#pragma once
+
 #include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 
+#include "Glass/Properties/PropertyUndoHistory.h"
+
 namespace Glass {
+	class BinaryReader;
+	class BinaryWriter;
+
 	class SimplePropertyHolder {
 	public:
+		SimplePropertyHolder() = default;
+		//! The undo history moves with the properties, and its edits of `other` become edits of
+		//! this holder
+		SimplePropertyHolder(SimplePropertyHolder&& other) noexcept;
+		//! Detaches this holder from its own undo history first
+		SimplePropertyHolder& operator=(SimplePropertyHolder&& other) noexcept;
+		~SimplePropertyHolder();
+
+		//! `scratchSpace` is kept with the value and given to the serializer of the property
+		//! type (see ScratchSpaceAndValue)
 		bool CreateProperty(std::string_view name,
 		                    std::string_view typeName,
 		                    boost::any value,
@@ -28,18 +45,185 @@ namespace Glass {
 
 		template <typename T> std::optional<T> GetProperty(const std::string_view name) const;
 
+		//! Pointer to the value of a property, or nullptr if there's no such property or it
+		//! isn't a T.  The pointer stays valid until the property is next set.
+		template <typename T> const T* GetPropertyPointer(std::string_view name) const;
+
+		//! Setting a value keeps the property's scratch space.  The value is assigned over the
+		//! existing one where possible, so an rvalue is moved into place.
 		template <typename T> bool SetProperty(const std::string_view name, T&& value);
 
+		//! Call `fn` with a mutable reference to the value of a property, then fire its signal
+		//! once.  Returns false, without calling `fn`, if there's no such property or it isn't
+		//! a T.
+		template <typename T, typename F> bool ModifyProperty(std::string_view name, F&& fn);
+
+		//! The number of the property named `name` (see GetPropertyCount), or std::nullopt if
+		//! there isn't one
+		std::optional<size_t> FindPropertyIndex(std::string_view name) const;
+
+		//! GetPropertyPointer and SetProperty for the property numbered `index` (see
+		//! GetPropertyCount), which avoid looking the property up by name
+		template <typename T> const T* GetPropertyPointerAt(size_t index) const;
+		template <typename T> bool SetPropertyAt(size_t index, T&& value);
+
+		//! SetPropertyAt for a value derived from other properties, such as a computed property
+		//! (see ComputedPropertyDefinition).  No edit is recorded in the undo history, since
+		//! undoing the edits of the properties it is derived from updates it.
+		template <typename T> bool SetDerivedPropertyAt(size_t index, T&& value);
+
+		//! SetPropertyAt without firing the property's signal, so that several properties can
+		//! be set before any of their handlers run.  The property is marked dirty and its edit
+		//! recorded right away, unless `shouldRecordEdit` is false (see SetDerivedPropertyAt).
+		//! Call FirePropertySignal for it once every property is set.
+		template <typename T>
+		bool AssignPropertyAt(size_t index, T&& value, bool shouldRecordEdit = true);
+
+		//! Fire the signal of the property numbered `index`, after AssignPropertyAt
+		void FirePropertySignal(size_t index);
+
+		//! The scratch space of a property, which is empty if its type doesn't use any.
+		//! Returns nullptr if there's no property named `name`.
+		const boost::any* GetPropertyScratchSpace(std::string_view name) const;
+
+		//! GetPropertyScratchSpace for the property numbered `index`
+		const boost::any& GetPropertyScratchSpaceAt(size_t index) const {
+			ZASSERT(index < m_propertiesByIndex.size());
+			return m_propertiesByIndex[index]->scratchSpace;
+		}
+
+		//! Replace the scratch space of the property numbered `index`, without firing its
+		//! signal.  Set its value afterwards, so that the signal's handlers see both.
+		void SetPropertyScratchSpaceAt(size_t index, boost::any scratchSpace) {
+			ZASSERT(index < m_propertiesByIndex.size());
+			m_propertiesByIndex[index]->scratchSpace = std::move(scratchSpace);
+		}
+
+		//! Serialize a property with its globally registered type, along with its scratch space.
+		//! Returns std::nullopt if there's no such property or it fails to serialize.
+		std::optional<std::string> SerializeProperty(std::string_view name) const;
+
+		//! Set a property, and its scratch space, from a value serialized by its globally
+		//! registered type, and fire its signal.  Types with an in place deserializer (see
+		//! PropertyType), such as strings and vectors, deserialize into the existing value, so
+		//! deserializing the same property again reuses its storage.  Returns false, leaving the
+		//! property as it was, if there's no such property or the value fails to deserialize.
+		bool DeserializeProperty(std::string_view name,
+		                         const std::string& serializedValue,
+		                         const boost::any& context = {});
+
 		Signal<>& GetPropertySignal(std::string_view name);
 
+		//! Type names of all properties in this holder, in no particular order.  The views are
+		//! valid for the lifetime of the holder.
+		vector<std::string_view> GetPropertyTypeNames() const;
+
+		//! Write every property whose type has a binary codec (see PropertyType) to `writer`.
+		//! Properties are written in name order, so holders with equal values produce equal
+		//! bytes.  Values that fail to encode are left out.
+		void SerializeBinary(BinaryWriter& writer) const;
+
+		//! Read properties written by SerializeBinary, firing the signal of each property that
+		//! is set.  Properties that don't exist in this holder, that have a different type name,
+		//! or that fail to decode are skipped.  Returns false if the data is malformed, in which
+		//! case properties read before the error keep their new values.
+		bool DeserializeBinary(BinaryReader& reader);
+
+		//! Number of properties created in this holder.  Properties are numbered in the order
+		//! they were created, from 0.
+		size_t GetPropertyCount() const { return m_isDirty.size(); }
+
+		//! Incremented every time any property of this holder is set, so polling code can tell
+		//! that nothing changed by comparing a single number.  Creating properties doesn't
+		//! change the version.
+		uint64_t GetVersion() const { return m_version; }
+
+		//! Whether the property numbered `index` was set since the last call to ConsumeDirty for
+		//! it, clearing its dirty flag.  Setting a property marks it dirty whether or not its
+		//! value changed, just as its signal fires.
+		bool ConsumeDirty(size_t index);
+
+		//! Write the value of the property numbered `index` to `writer`, with its type's binary
+		//! codec if it has one and otherwise with its registered serializer.  Returns false,
+		//! possibly after writing part of the value, if its type isn't registered or it fails to
+		//! encode.
+		bool EncodeProperty(size_t index, BinaryWriter& writer) const;
+
+		//! Set the property numbered `index` from everything in `reader`, written by
+		//! EncodeProperty for a property of the same type, and fire its signal.  Returns false,
+		//! leaving the property as it was, if the value fails to decode.
+		bool DecodeProperty(size_t index, BinaryReader& reader);
+
+		//! Record edits made with SetProperty and ModifyProperty in `history`, or stop recording
+		//! if it's nullptr.  The holder's edits are removed from its previous history, if any.
+		void SetUndoHistory(PropertyUndoHistory* history);
+
+		//! The value GetVersion returned just after the property numbered `index` was last set,
+		//! or 0 if it hasn't been set since it was created.  Unlike ConsumeDirty this doesn't
+		//! change anything, so any number of callers can each keep their own checkpoint
+		//! version and compare against it.
+		uint64_t GetPropertyVersion(size_t index) const {
+			ZASSERT(index < m_propertyVersions.size());
+			return m_propertyVersions[index];
+		}
+
+		//! Whether the property numbered `index` has the same type and an equal value as the
+		//! property numbered `otherIndex` of `other`.  Values are compared with their type's
+		//! registered comparison (see areValuesEqual), and types that can't be compared are
+		//! compared by their serialized strings.
+		bool IsPropertyEqual(size_t index,
+		                     const SimplePropertyHolder& other,
+		                     size_t otherIndex) const;
+
 	private:
+		friend class PropertyUndoHistory;
+
 		struct PropertyValue {
+			std::string typeName;
 			boost::any value;
+			boost::any scratchSpace;
+			//! The number of the property, in creation order
+			size_t index;
 			Signal<> signal{};
 		};
+
+		template <typename T>
+		bool setProperty(PropertyValue& property,
+		                 T&& value,
+		                 bool shouldRecordEdit = true,
+		                 bool shouldFireSignal = true);
+
+		//! Mark a property dirty and bump the version
+		void markChanged(PropertyValue& property);
+		//! markChanged, then fire the property's signal
+		void didChange(PropertyValue& property);
+
+		//! Take over the undo history of `other`, which this holder was moved from
+		void takeUndoHistory(SimplePropertyHolder& other);
+
+		//! Set the property numbered `index` to `value` with `assign`, without recording an
+		//! edit.  Used by PropertyUndoHistory.
+		void restoreProperty(size_t index,
+		                     void (*assign)(boost::any& target, const void* value),
+		                     const void* value);
+
 		std::unordered_map<std::string, PropertyValue> m_propertyValues;
+		//! Indexed by PropertyValue::index
+		vector<bool> m_isDirty;
+		//! Indexed by PropertyValue::index
+		vector<uint64_t> m_propertyVersions;
+		//! Indexed by PropertyValue::index.  Elements of unordered_map don't move, so these stay
+		//! valid.
+		vector<PropertyValue*> m_propertiesByIndex;
+		uint64_t m_version = 0;
+		PropertyUndoHistory* m_undoHistory = nullptr;
 	};
 
+	//! The numbers of the properties that differ between `lhs` and `rhs`, in increasing order.
+	//! The holders are expected to belong to objects of the same class, so that properties with
+	//! the same number correspond; properties that only one holder has are always included.
+	//! See SimplePropertyHolder::IsPropertyEqual.
+	vector<size_t> DiffProperties(const SimplePropertyHolder& lhs, const SimplePropertyHolder& rhs);
 
 	template <typename T>
 	inline std::optional<T> SimplePropertyHolder::GetProperty(std::string_view name) const {
@@ -60,6 +244,21 @@ namespace Glass {
 		return *value;
 	}
 
+	template <typename T>
+	inline const T* SimplePropertyHolder::GetPropertyPointer(std::string_view name) const {
+		const auto it = m_propertyValues.find(std::string{name});
+		if (it == m_propertyValues.end()) {
+			return nullptr;
+		}
+		return boost::any_cast<T>(&it->second.value);
+	}
+
+	template <typename T>
+	inline const T* SimplePropertyHolder::GetPropertyPointerAt(size_t index) const {
+		ZASSERT(index < m_propertiesByIndex.size());
+		return boost::any_cast<T>(&m_propertiesByIndex[index]->value);
+	}
+
 	template <typename T>
 	inline bool SimplePropertyHolder::SetProperty(std::string_view name, T&& value) {
 		auto it = std::find_if(m_propertyValues.begin(),
@@ -70,12 +269,89 @@ namespace Glass {
 			return {};
 		}
 
-		if (!boost::any_cast<std::remove_cv_t<std::remove_reference_t<T>>>(&(it->second.value))) {
+		return setProperty(it->second, std::forward<T>(value));
+	}
+
+	template <typename T>
+	inline bool SimplePropertyHolder::SetPropertyAt(size_t index, T&& value) {
+		ZASSERT(index < m_propertiesByIndex.size());
+		return setProperty(*m_propertiesByIndex[index], std::forward<T>(value));
+	}
+
+	template <typename T>
+	inline bool SimplePropertyHolder::SetDerivedPropertyAt(size_t index, T&& value) {
+		ZASSERT(index < m_propertiesByIndex.size());
+		return setProperty(*m_propertiesByIndex[index], std::forward<T>(value), false);
+	}
+
+	template <typename T>
+	inline bool
+	SimplePropertyHolder::AssignPropertyAt(size_t index, T&& value, bool shouldRecordEdit) {
+		ZASSERT(index < m_propertiesByIndex.size());
+		return setProperty(
+		    *m_propertiesByIndex[index], std::forward<T>(value), shouldRecordEdit, false);
+	}
+
+	template <typename T>
+	inline bool SimplePropertyHolder::setProperty(PropertyValue& property,
+	                                              T&& value,
+	                                              bool shouldRecordEdit,
+	                                              bool shouldFireSignal) {
+		using Value = std::remove_cv_t<std::remove_reference_t<T>>;
+		auto* existing = boost::any_cast<Value>(&property.value);
+		if (!existing) {
+			return false;
+		}
+
+		auto assign = [&] {
+			if constexpr (std::is_assignable_v<Value&, T&&>) {
+				*existing = std::forward<T>(value);
+			} else {
+				property.value = std::forward<T>(value);
+			}
+		};
+		if (m_undoHistory && shouldRecordEdit) {
+			auto oldValue = *existing;
+			assign();
+			m_undoHistory->RecordEdit(*this,
+			                          property.index,
+			                          std::move(oldValue),
+			                          *boost::any_cast<Value>(&property.value));
+		} else {
+			assign();
+		}
+		if (shouldFireSignal) {
+			didChange(property);
+		} else {
+			markChanged(property);
+		}
+
+		return true;
+	}
+
+	template <typename T, typename F>
+	inline bool SimplePropertyHolder::ModifyProperty(std::string_view name, F&& fn) {
+		auto it = std::find_if(m_propertyValues.begin(),
+		                       m_propertyValues.end(),
+		                       [&](const auto& e) { return std::string_view{e.first} == name; });
+
+		if (it == m_propertyValues.end()) {
 			return {};
 		}
 
-		it->second.value = std::forward<T>(value);
-		it->second.signal();
+		auto* value = boost::any_cast<T>(&(it->second.value));
+		if (!value) {
+			return {};
+		}
+
+		if (m_undoHistory) {
+			auto oldValue = *value;
+			std::forward<F>(fn)(*value);
+			m_undoHistory->RecordEdit(*this, it->second.index, std::move(oldValue), *value);
+		} else {
+			std::forward<F>(fn)(*value);
+		}
+		didChange(it->second);
 
 		return true;
 	}
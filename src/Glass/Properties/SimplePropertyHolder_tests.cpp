@@ -15,7 +15,11 @@
 
 #include "iZBase/common/common.h"
 
+#include "Glass/Properties/Private/GlobalPropertyData.h"
 #include "Glass/Properties/SimplePropertyHolder.h"
+#include "Glass/Properties/Types/BinaryCodec.h"
+#include "Glass/Properties/Types/Builtins.h"
+#include "Glass/Properties/Types/ScratchSpaceAndValue.h"
 
 IZ_PUSH_ALL_WARNINGS
 #include "gtest/gtest.h"
@@ -24,6 +28,42 @@ IZ_POP_ALL_WARNINGS
 namespace {
 	using Glass::SimplePropertyHolder;
 
+	//! An int that keeps the text it was deserialized from as scratch space, so that it is
+	//! serialized the same way as long as the value doesn't change
+	struct PaddedIntPropertyType : Glass::PropertyType<int32_t> {
+		static constexpr auto name = "PaddedInt";
+		using scratch_type = std::string;
+		static std::optional<std::string> serialize(int32_t value, const std::string* scratch) {
+			if (scratch && std::stoi(*scratch) == value) {
+				return *scratch;
+			}
+			return std::to_string(value);
+		}
+		static std::optional<Glass::ScratchSpaceAndValue<scratch_type, type>>
+		deserialize(const std::string& serializedValue) {
+			if (serializedValue.empty() ||
+			    serializedValue.find_first_not_of("0123456789") != std::string::npos) {
+				return std::nullopt;
+			}
+			return Glass::ScratchSpaceAndValue<scratch_type, type>{serializedValue,
+			                                                       std::stoi(serializedValue)};
+		}
+	};
+
+	//! A point without operator==, so it can only be compared by its serialized string
+	struct Point {
+		int32_t x;
+		int32_t y;
+	};
+
+	struct PointPropertyType : Glass::PropertyType<Point> {
+		static constexpr auto name = "Point";
+		static std::string serialize(const Point& value) {
+			return std::to_string(value.x) + "," + std::to_string(value.y);
+		}
+		static std::optional<Point> deserialize(const std::string&) { return std::nullopt; }
+	};
+
 	TEST(SimplePropertyHolderTests, CreateProperty) {
 		auto ph = SimplePropertyHolder{};
 		ASSERT_TRUE(ph.CreateProperty("Foo", "Int", 42));
@@ -135,4 +175,197 @@ namespace {
 		ASSERT_TRUE(didFireBarSignal);
 	}
 
+	TEST(SimplePropertyHolderTests, BinaryRoundTrip) {
+		auto source = SimplePropertyHolder{};
+		source.CreateProperty("Foo", "Int", 42);
+		source.CreateProperty("Bar", "std::string", std::string{"hello"});
+		source.CreateProperty("Baz", "Unregistered Type", 3.14);
+
+		Glass::BinaryWriter writer;
+		source.SerializeBinary(writer);
+
+		auto destination = SimplePropertyHolder{};
+		destination.CreateProperty("Foo", "Int", 0);
+		destination.CreateProperty("Bar", "std::string", std::string{});
+		destination.CreateProperty("Baz", "Unregistered Type", 0.0);
+
+		bool didFireSignal = false;
+		Trackable t{};
+		destination.GetPropertySignal("Foo").Connect(&t, [&] { didFireSignal = true; });
+
+		const auto& buffer = writer.GetBuffer();
+		Glass::BinaryReader reader{buffer.data(), buffer.size()};
+		ASSERT_TRUE(destination.DeserializeBinary(reader));
+		ASSERT_TRUE(reader.IsAtEnd());
+		ASSERT_EQ(42, *destination.GetProperty<int>("Foo"));
+		ASSERT_EQ(std::string{"hello"}, *destination.GetProperty<std::string>("Bar"));
+		ASSERT_EQ(0.0, *destination.GetProperty<double>("Baz"));
+		ASSERT_TRUE(didFireSignal);
+	}
+
+	TEST(SimplePropertyHolderTests, BinarySkipsMismatchedTypes) {
+		auto source = SimplePropertyHolder{};
+		source.CreateProperty("Foo", "Int", 42);
+		source.CreateProperty("Bar", "Float", 1.5f);
+
+		Glass::BinaryWriter writer;
+		source.SerializeBinary(writer);
+
+		auto destination = SimplePropertyHolder{};
+		destination.CreateProperty("Foo", "Float", 0.f);
+		destination.CreateProperty("Bar", "Float", 0.f);
+
+		const auto& buffer = writer.GetBuffer();
+		Glass::BinaryReader reader{buffer.data(), buffer.size()};
+		ASSERT_TRUE(destination.DeserializeBinary(reader));
+		ASSERT_EQ(0.f, *destination.GetProperty<float>("Foo"));
+		ASSERT_EQ(1.5f, *destination.GetProperty<float>("Bar"));
+	}
+
+	TEST(SimplePropertyHolderTests, BinarySkipsValuesThatFailToEncode) {
+		auto source = SimplePropertyHolder{};
+		source.CreateProperty("Foo", "Int", 42);
+		// Not an int, so the Int codec can't encode it
+		source.CreateProperty("Bar", "Int", 1.5);
+
+		Glass::BinaryWriter writer;
+		source.SerializeBinary(writer);
+
+		auto destination = SimplePropertyHolder{};
+		destination.CreateProperty("Foo", "Int", 0);
+		destination.CreateProperty("Bar", "Int", 0);
+
+		const auto& buffer = writer.GetBuffer();
+		Glass::BinaryReader reader{buffer.data(), buffer.size()};
+		ASSERT_TRUE(destination.DeserializeBinary(reader));
+		ASSERT_TRUE(reader.IsAtEnd());
+		ASSERT_EQ(42, *destination.GetProperty<int>("Foo"));
+		ASSERT_EQ(0, *destination.GetProperty<int>("Bar"));
+	}
+
+	TEST(SimplePropertyHolderTests, BinaryTruncatedDataFails) {
+		auto source = SimplePropertyHolder{};
+		source.CreateProperty("Foo", "Int", 42);
+
+		Glass::BinaryWriter writer;
+		source.SerializeBinary(writer);
+
+		auto destination = SimplePropertyHolder{};
+		destination.CreateProperty("Foo", "Int", 0);
+
+		const auto& buffer = writer.GetBuffer();
+		Glass::BinaryReader reader{buffer.data(), buffer.size() - 1};
+		ASSERT_FALSE(destination.DeserializeBinary(reader));
+		ASSERT_EQ(0, *destination.GetProperty<int>("Foo"));
+	}
+
+	TEST(SimplePropertyHolderTests, ScratchSpaceRoundTrip) {
+		Glass::Private::GlobalPropertyData::AddPropertyTypeData<PaddedIntPropertyType>();
+		auto ph = SimplePropertyHolder{};
+		ph.CreateProperty("Foo", PaddedIntPropertyType::name, 0, std::string{"000"});
+		ASSERT_EQ(std::string{"000"}, *ph.SerializeProperty("Foo"));
+
+		bool didFireSignal = false;
+		Trackable t{};
+		ph.GetPropertySignal("Foo").Connect(&t, [&] { didFireSignal = true; });
+		ASSERT_TRUE(ph.DeserializeProperty("Foo", "0042"));
+		ASSERT_TRUE(didFireSignal);
+		ASSERT_EQ(42, *ph.GetProperty<int32_t>("Foo"));
+		ASSERT_EQ(std::string{"0042"}, *ph.SerializeProperty("Foo"));
+
+		// Setting the value keeps the scratch space, and the serializer decides whether to use it
+		ph.SetProperty("Foo", int32_t{7});
+		ASSERT_EQ(std::string{"0042"},
+		          boost::any_cast<std::string>(*ph.GetPropertyScratchSpace("Foo")));
+		ASSERT_EQ(std::string{"7"}, *ph.SerializeProperty("Foo"));
+	}
+
+	TEST(SimplePropertyHolderTests, DeserializeReusesStorage) {
+		Glass::Private::GlobalPropertyData::AddPropertyTypeData<PaddedIntPropertyType>();
+		auto ph = SimplePropertyHolder{};
+		ph.CreateProperty("Foo", PaddedIntPropertyType::name, 0);
+		ASSERT_TRUE(ph.GetPropertyScratchSpace("Foo")->empty());
+
+		ASSERT_TRUE(ph.DeserializeProperty("Foo", "01"));
+		const auto* scratch = boost::any_cast<std::string>(ph.GetPropertyScratchSpace("Foo"));
+		ASSERT_TRUE(scratch);
+		ASSERT_TRUE(ph.DeserializeProperty("Foo", "002"));
+		ASSERT_EQ(scratch, boost::any_cast<std::string>(ph.GetPropertyScratchSpace("Foo")));
+		ASSERT_EQ(std::string{"002"}, *scratch);
+	}
+
+	TEST(SimplePropertyHolderTests, DeserializeFailureKeepsProperty) {
+		Glass::Private::GlobalPropertyData::AddPropertyTypeData<PaddedIntPropertyType>();
+		auto ph = SimplePropertyHolder{};
+		ph.CreateProperty("Foo", PaddedIntPropertyType::name, 5, std::string{"05"});
+		ph.CreateProperty("Bar", "Unregistered Type", 3.14);
+
+		ASSERT_FALSE(ph.DeserializeProperty("Foo", "-1"));
+		ASSERT_FALSE(ph.DeserializeProperty("Bar", "1"));
+		ASSERT_FALSE(ph.DeserializeProperty("Baz", "1"));
+		ASSERT_FALSE(ph.SerializeProperty("Bar"));
+		ASSERT_EQ(5, *ph.GetProperty<int32_t>("Foo"));
+		ASSERT_EQ(std::string{"05"}, *ph.SerializeProperty("Foo"));
+	}
+
+	TEST(SimplePropertyHolderTests, DeserializeWithoutScratchSpace) {
+		auto ph = SimplePropertyHolder{};
+		ph.CreateProperty("Foo", Glass::IntPropertyType::name, 0);
+		ASSERT_TRUE(ph.DeserializeProperty("Foo", "54"));
+		ASSERT_EQ(54, *ph.GetProperty<int32_t>("Foo"));
+		ASSERT_TRUE(ph.GetPropertyScratchSpace("Foo")->empty());
+		ASSERT_EQ(std::string{"54"}, *ph.SerializeProperty("Foo"));
+	}
+
+	TEST(SimplePropertyHolderTests, DirtyAndVersion) {
+		auto ph = SimplePropertyHolder{};
+		ph.CreateProperty("Foo", Glass::IntPropertyType::name, 0);
+		ph.CreateProperty("Bar", Glass::IntPropertyType::name, 0);
+		ASSERT_EQ(2u, ph.GetPropertyCount());
+		ASSERT_EQ(0u, ph.GetVersion());
+		ASSERT_FALSE(ph.ConsumeDirty(0));
+		ASSERT_FALSE(ph.ConsumeDirty(1));
+
+		ph.SetProperty("Bar", int32_t{1});
+		ASSERT_TRUE(ph.DeserializeProperty("Bar", "2"));
+		ASSERT_EQ(2u, ph.GetVersion());
+		ASSERT_EQ(0u, ph.GetPropertyVersion(0));
+		ASSERT_EQ(2u, ph.GetPropertyVersion(1));
+		ASSERT_FALSE(ph.ConsumeDirty(0));
+		ASSERT_TRUE(ph.ConsumeDirty(1));
+		ASSERT_FALSE(ph.ConsumeDirty(1));
+
+		// Failed sets change nothing
+		ASSERT_FALSE(ph.SetProperty("Foo", 1.f));
+		ASSERT_FALSE(ph.DeserializeProperty("Foo", "not an int"));
+		ASSERT_EQ(2u, ph.GetVersion());
+		ASSERT_FALSE(ph.ConsumeDirty(0));
+	}
+
+	TEST(SimplePropertyHolderTests, DiffProperties) {
+		Glass::Private::GlobalPropertyData::AddPropertyTypeData<PointPropertyType>();
+		auto createProperties = [](SimplePropertyHolder& ph) {
+			ph.CreateProperty("Foo", Glass::IntPropertyType::name, 0);
+			ph.CreateProperty("Bar", Glass::StringPropertyType::name, std::string{"bar"});
+			ph.CreateProperty("Baz", PointPropertyType::name, Point{1, 2});
+		};
+		SimplePropertyHolder lhs;
+		SimplePropertyHolder rhs;
+		createProperties(lhs);
+		createProperties(rhs);
+		ASSERT_TRUE(Glass::DiffProperties(lhs, rhs).empty());
+
+		rhs.SetProperty("Foo", int32_t{1});
+		rhs.SetProperty("Baz", Point{1, 3});
+		ASSERT_EQ((vector<size_t>{0, 2}), Glass::DiffProperties(lhs, rhs));
+		lhs.SetProperty("Baz", Point{1, 3});
+		lhs.SetProperty("Bar", std::string{"baz"});
+		ASSERT_EQ((vector<size_t>{0, 1}), Glass::DiffProperties(lhs, rhs));
+
+		// Properties only one holder has always differ, as do properties of different types
+		rhs.CreateProperty("Qux", Glass::IntPropertyType::name, 0);
+		ASSERT_EQ((vector<size_t>{0, 1, 3}), Glass::DiffProperties(lhs, rhs));
+		lhs.CreateProperty("Qux", Glass::FloatPropertyType::name, 0.f);
+		ASSERT_EQ((vector<size_t>{0, 1, 3}), Glass::DiffProperties(lhs, rhs));
+	}
 }
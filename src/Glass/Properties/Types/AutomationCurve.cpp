@@ -0,0 +1,184 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include "Glass/Properties/Types/AutomationCurve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "Glass/Properties/RegisterPropertyType.h"
+#include "Glass/Properties/Types/Builtins.h"
+#include "Glass/Properties/Types/Private/parseSimpleNumber.h"
+
+using Glass::AutomationCurve;
+using Glass::AutomationCurvePropertyType;
+
+AutomationCurve::AutomationCurve(vector<float> times, vector<float> values) {
+	ZASSERT(times.size() == values.size());
+	vector<size_t> order(times.size());
+	std::iota(order.begin(), order.end(), size_t{0});
+	std::stable_sort(
+	    order.begin(), order.end(), [&](size_t a, size_t b) { return times[a] < times[b]; });
+	m_times.reserve(order.size());
+	m_values.reserve(order.size());
+	for (const auto i : order) {
+		m_times.push_back(times[i]);
+		m_values.push_back(values[i]);
+	}
+}
+
+void AutomationCurve::AddKeyframe(float time, float value) {
+	const auto position = static_cast<size_t>(
+	    std::upper_bound(m_times.begin(), m_times.end(), time) - m_times.begin());
+	m_times.insert(m_times.begin() + position, time);
+	m_values.insert(m_values.begin() + position, value);
+	m_cachedSegment = 0;
+}
+
+float AutomationCurve::Evaluate(float time) const {
+	return evaluate(time, m_cachedSegment);
+}
+
+void AutomationCurve::Evaluate(gsl::span<const float> times, gsl::span<float> values) const {
+	ZASSERT(times.size() == values.size());
+	auto segment = m_cachedSegment;
+	auto value = values.begin();
+	for (const auto time : times) {
+		*value = evaluate(time, segment);
+		++value;
+	}
+	m_cachedSegment = segment;
+}
+
+size_t AutomationCurve::findSegment(float time, size_t segment) const {
+	const auto lastSegment = m_times.size() - 2;
+	segment = std::min(segment, lastSegment);
+	// Playback moves forward, so try the cached segment and the one after it first
+	if (m_times[segment] <= time) {
+		if (time < m_times[segment + 1]) {
+			return segment;
+		}
+		if (segment < lastSegment && time < m_times[segment + 2]) {
+			return segment + 1;
+		}
+	}
+	const auto next = std::upper_bound(m_times.begin(), m_times.end(), time);
+	return std::min(static_cast<size_t>(next - m_times.begin()) - 1, lastSegment);
+}
+
+float AutomationCurve::evaluate(float time, size_t& segment) const {
+	const auto count = m_times.size();
+	if (count == 0) {
+		return 0.f;
+	}
+	// Written so that NaN times also evaluate to the first value, since they would otherwise
+	// get past both bounds checks
+	if (count == 1 || !(time > m_times.front())) {
+		return m_values.front();
+	}
+	if (time >= m_times.back()) {
+		return m_values.back();
+	}
+	segment = findSegment(time, segment);
+	const auto startTime = m_times[segment];
+	const auto endTime = m_times[segment + 1];
+	const auto startValue = m_values[segment];
+	const auto endValue = m_values[segment + 1];
+	return startValue + (endValue - startValue) * ((time - startTime) / (endTime - startTime));
+}
+
+std::string AutomationCurvePropertyType::serialize(const type& value) {
+	std::string serialized;
+	const auto times = value.GetTimes();
+	const auto values = value.GetValues();
+	for (size_t i = 0; i < value.GetKeyframeCount(); ++i) {
+		if (i > 0) {
+			serialized += ", ";
+		}
+		serialized += FloatPropertyType::serialize(times[i]);
+		serialized += ' ';
+		serialized += FloatPropertyType::serialize(values[i]);
+	}
+	return serialized;
+}
+
+namespace {
+	std::optional<float> parseFloat(std::string_view text) {
+		if (const auto value = Glass::Private::parseSimpleFloat(text)) {
+			return value;
+		}
+		return Glass::FloatPropertyType::deserialize(std::string{text});
+	}
+}
+
+std::optional<AutomationCurve>
+AutomationCurvePropertyType::deserialize(const std::string& serializedValue) {
+	vector<float> times;
+	vector<float> values;
+	std::string_view remaining = serializedValue;
+	while (!remaining.empty()) {
+		const auto separator = remaining.find(',');
+		auto keyframe = remaining.substr(0, separator);
+		remaining = separator == std::string_view::npos ? std::string_view{}
+		                                                : remaining.substr(separator + 1);
+		while (!keyframe.empty() && keyframe.front() == ' ') {
+			keyframe.remove_prefix(1);
+		}
+		const auto space = keyframe.find(' ');
+		if (space == std::string_view::npos) {
+			return std::nullopt;
+		}
+		const auto time = parseFloat(keyframe.substr(0, space));
+		const auto value = parseFloat(keyframe.substr(space + 1));
+		if (!time || !value || std::isnan(*time)) {
+			return std::nullopt;
+		}
+		times.push_back(*time);
+		values.push_back(*value);
+	}
+	return AutomationCurve{std::move(times), std::move(values)};
+}
+
+void AutomationCurvePropertyType::serializeBinary(const type& value, BinaryWriter& writer) {
+	writer.WriteSize(value.GetKeyframeCount());
+	const auto times = value.GetTimes();
+	const auto values = value.GetValues();
+	writer.WriteBytes(times.data(), times.size() * sizeof(float));
+	writer.WriteBytes(values.data(), values.size() * sizeof(float));
+}
+
+std::optional<AutomationCurve>
+AutomationCurvePropertyType::deserializeBinary(BinaryReader& reader) {
+	const auto count = reader.ReadSize();
+	if (!count || *count > reader.GetRemaining() / (2 * sizeof(float))) {
+		return std::nullopt;
+	}
+	vector<float> times(*count);
+	vector<float> values(*count);
+	if (!reader.ReadBytes(times.data(), times.size() * sizeof(float)) ||
+	    !reader.ReadBytes(values.data(), values.size() * sizeof(float))) {
+		return std::nullopt;
+	}
+	if (std::any_of(times.begin(), times.end(), [](float time) { return std::isnan(time); })) {
+		return std::nullopt;
+	}
+	return AutomationCurve{std::move(times), std::move(values)};
+}
+
+GLASS_REGISTER_PROPERTY_TYPE(AutomationCurvePropertyType)
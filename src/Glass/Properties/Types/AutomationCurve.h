@@ -0,0 +1,86 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#pragma once
+
+#include "gsl/span"
+
+#include "Glass/Properties/Types/PropertyType.h"
+
+namespace Glass {
+	//! Piecewise linear curve through keyframes of (time, value), for parameter automation.
+	//!
+	//! Keyframe times and values are kept sorted by time in two contiguous arrays.  Before the
+	//! first keyframe the curve holds the first value, and after the last it holds the last.
+	//! Keyframes may share a time, which makes a jump to the later keyframe's value.
+	//!
+	//! Evaluating remembers the segment it landed in, so evaluating at increasing times, as
+	//! playback does, finds each segment in constant time instead of searching.  Because of
+	//! that cache, a curve must not be evaluated from several threads at once.
+	class AutomationCurve {
+	public:
+		AutomationCurve() = default;
+
+		//! `times` and `values` must have the same size.  The keyframes are sorted by time,
+		//! keeping the order of keyframes with equal times.
+		AutomationCurve(vector<float> times, vector<float> values);
+
+		//! Insert a keyframe after any keyframes with the same time
+		void AddKeyframe(float time, float value);
+
+		size_t GetKeyframeCount() const { return m_times.size(); }
+		gsl::span<const float> GetTimes() const { return m_times; }
+		gsl::span<const float> GetValues() const { return m_values; }
+
+		//! The value of the curve at `time`, or 0 if it has no keyframes.  A NaN time gives the
+		//! value of the first keyframe.
+		float Evaluate(float time) const;
+
+		//! Set each of `values` to the value of the curve at the time with the same index in
+		//! `times`, which has the same size.  This is fastest when `times` increase, as when
+		//! drawing a lane.
+		void Evaluate(gsl::span<const float> times, gsl::span<float> values) const;
+
+		//! Curves are equal if they have the same keyframes
+		bool operator==(const AutomationCurve& other) const {
+			return m_times == other.m_times && m_values == other.m_values;
+		}
+		bool operator!=(const AutomationCurve& other) const { return !(*this == other); }
+
+	private:
+		//! The segment [i, i + 1] whose times contain `time`, starting the search from
+		//! `segment`.  The curve must have at least two keyframes, and `time` must be within
+		//! them.
+		size_t findSegment(float time, size_t segment) const;
+
+		float evaluate(float time, size_t& segment) const;
+
+		vector<float> m_times;
+		vector<float> m_values;
+		//! The segment of the last evaluation
+		mutable size_t m_cachedSegment = 0;
+	};
+
+	//! Serialized as comma separated "time value" pairs, e.g. "0 0, 1.5 0.25, 4 1"
+	struct AutomationCurvePropertyType : PropertyType<AutomationCurvePropertyType> {
+		using type = AutomationCurve;
+		static constexpr auto name = "AutomationCurve";
+		static std::string serialize(const type& value);
+		static std::optional<type> deserialize(const std::string& serializedValue);
+		static void serializeBinary(const type& value, BinaryWriter& writer);
+		static std::optional<type> deserializeBinary(BinaryReader& reader);
+	};
+}
@@ -0,0 +1,120 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+
+#include "iZBase/common/common.h"
+
+#include <limits>
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+#include "Glass/Properties/Private/GlobalPropertyData.h"
+#include "Glass/Properties/Types/AutomationCurve.h"
+#include "Glass/Properties/Types/BinaryCodec.h"
+
+using namespace Glass;
+
+namespace {
+	AutomationCurve makeCurve() {
+		return AutomationCurve{{0.f, 1.f, 3.f, 3.f, 4.f}, {0.f, 1.f, 0.f, 2.f, 4.f}};
+	}
+}
+
+TEST(AutomationCurve, Empty) {
+	const AutomationCurve curve;
+	ASSERT_EQ(0.f, curve.Evaluate(1.f));
+}
+
+TEST(AutomationCurve, Evaluate) {
+	const auto curve = makeCurve();
+	ASSERT_EQ(0.f, curve.Evaluate(-1.f));
+	ASSERT_EQ(.5f, curve.Evaluate(.5f));
+	ASSERT_EQ(1.f, curve.Evaluate(1.f));
+	ASSERT_EQ(.5f, curve.Evaluate(2.f));
+	// Keyframes at the same time jump to the later value
+	ASSERT_EQ(2.f, curve.Evaluate(3.f));
+	ASSERT_EQ(3.f, curve.Evaluate(3.5f));
+	ASSERT_EQ(4.f, curve.Evaluate(10.f));
+	// Going backwards finds the segment again
+	ASSERT_EQ(.25f, curve.Evaluate(.25f));
+}
+
+TEST(AutomationCurve, SingleKeyframe) {
+	AutomationCurve curve;
+	curve.AddKeyframe(1.f, 2.f);
+	ASSERT_EQ(2.f, curve.Evaluate(0.f));
+	ASSERT_EQ(2.f, curve.Evaluate(3.f));
+	ASSERT_EQ(2.f, curve.Evaluate(std::numeric_limits<float>::quiet_NaN()));
+}
+
+TEST(AutomationCurve, NaNTime) {
+	const auto curve = makeCurve();
+	ASSERT_EQ(0.f, curve.Evaluate(std::numeric_limits<float>::quiet_NaN()));
+}
+
+TEST(AutomationCurve, EvaluateBatch) {
+	const auto curve = makeCurve();
+	const vector<float> times{-1.f, 0.f, .5f, 1.5f, 2.f, 3.f, 3.5f, 5.f, .5f};
+	vector<float> values(times.size());
+	curve.Evaluate(times, values);
+	for (size_t i = 0; i < times.size(); ++i) {
+		ASSERT_EQ(curve.Evaluate(times[i]), values[i]);
+	}
+}
+
+TEST(AutomationCurve, KeyframesAreSorted) {
+	AutomationCurve curve{{2.f, 0.f}, {1.f, 0.f}};
+	curve.AddKeyframe(1.f, 3.f);
+	curve.AddKeyframe(2.f, 5.f);
+	ASSERT_EQ((vector<float>{0.f, 1.f, 2.f, 2.f}),
+	          vector<float>(curve.GetTimes().begin(), curve.GetTimes().end()));
+	ASSERT_EQ((vector<float>{0.f, 3.f, 1.f, 5.f}),
+	          vector<float>(curve.GetValues().begin(), curve.GetValues().end()));
+}
+
+TEST(AutomationCurve, Serialization) {
+	const auto curve = makeCurve();
+	const auto serialized = AutomationCurvePropertyType::serialize(curve);
+	ASSERT_EQ(std::string{"0 0, 1 1, 3 0, 3 2, 4 4"}, serialized);
+	const auto deserialized = AutomationCurvePropertyType::deserialize(serialized);
+	ASSERT_TRUE(deserialized);
+	ASSERT_TRUE(curve == *deserialized);
+
+	ASSERT_TRUE(AutomationCurvePropertyType::deserialize(""));
+	ASSERT_FALSE(AutomationCurvePropertyType::deserialize("0 0, 1"));
+	ASSERT_FALSE(AutomationCurvePropertyType::deserialize("0 0, x 1"));
+}
+
+TEST(AutomationCurve, BinarySerialization) {
+	const auto curve = makeCurve();
+	BinaryWriter writer;
+	AutomationCurvePropertyType::serializeBinary(curve, writer);
+	const auto& buffer = writer.GetBuffer();
+	BinaryReader reader{buffer.data(), buffer.size()};
+	const auto deserialized = AutomationCurvePropertyType::deserializeBinary(reader);
+	ASSERT_TRUE(reader.IsAtEnd());
+	ASSERT_TRUE(deserialized);
+	ASSERT_TRUE(curve == *deserialized);
+
+	BinaryReader truncated{buffer.data(), buffer.size() - 1};
+	ASSERT_FALSE(AutomationCurvePropertyType::deserializeBinary(truncated));
+}
+
+TEST(AutomationCurve, IsRegistered) {
+	ASSERT_TRUE(Private::GlobalPropertyData::findPropertyTypeRegistration(
+	    AutomationCurvePropertyType::name));
+}
@@ -0,0 +1,146 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace Glass {
+	//! Append-only byte buffer used by the binary property codecs.
+	//!
+	//! Fixed width values are written in host byte order (all of our supported platforms are
+	//! little endian).  Strings and other variable length data are prefixed with a uint32_t
+	//! length.
+	class BinaryWriter {
+	public:
+		void WriteBytes(const void* data, size_t size) {
+			const auto* bytes = static_cast<const uint8_t*>(data);
+			m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+		}
+
+		template <typename T> void Write(const T& value) {
+			static_assert(std::is_trivially_copyable_v<T>,
+			              "Write only supports trivially copyable types.");
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void WriteSize(size_t size) { Write(static_cast<uint32_t>(size)); }
+
+		void WriteString(std::string_view value) {
+			WriteSize(value.size());
+			WriteBytes(value.data(), value.size());
+		}
+
+		//! Overwrite a previously written uint32_t, e.g., to fill in a length once it is known.
+		void PatchSize(size_t offset, size_t size) {
+			const auto value = static_cast<uint32_t>(size);
+			ZASSERT(offset + sizeof(value) <= m_buffer.size());
+			std::memcpy(m_buffer.data() + offset, &value, sizeof(value));
+		}
+
+		//! Discard everything written after the first `size` bytes, e.g., to drop a value that
+		//! failed to encode.
+		void Truncate(size_t size) {
+			ZASSERT(size <= m_buffer.size());
+			m_buffer.resize(size);
+		}
+
+		size_t GetSize() const { return m_buffer.size(); }
+		const vector<uint8_t>& GetBuffer() const { return m_buffer; }
+		vector<uint8_t> TakeBuffer() { return std::move(m_buffer); }
+
+	private:
+		vector<uint8_t> m_buffer;
+	};
+
+	//! Non-owning cursor over data written by BinaryWriter.
+	//!
+	//! All reads are bounds checked; a read past the end of the data fails and leaves the reader
+	//! where it was.
+	class BinaryReader {
+	public:
+		BinaryReader(const uint8_t* data, size_t size)
+		    : m_position{data}
+		    , m_end{data + size} {}
+
+		bool ReadBytes(void* out, size_t size) {
+			if (GetRemaining() < size) {
+				return false;
+			}
+			std::memcpy(out, m_position, size);
+			m_position += size;
+			return true;
+		}
+
+		template <typename T> std::optional<T> Read() {
+			static_assert(std::is_trivially_copyable_v<T>,
+			              "Read only supports trivially copyable types.");
+			T value;
+			if (!ReadBytes(&value, sizeof(T))) {
+				return std::nullopt;
+			}
+			return value;
+		}
+
+		std::optional<size_t> ReadSize() {
+			const auto size = Read<uint32_t>();
+			if (!size) {
+				return std::nullopt;
+			}
+			return static_cast<size_t>(*size);
+		}
+
+		//! The returned view points into the underlying data and is only valid as long as it is.
+		std::optional<std::string_view> ReadStringView() {
+			const auto size = ReadSize();
+			if (!size || GetRemaining() < *size) {
+				return std::nullopt;
+			}
+			auto value = std::string_view{reinterpret_cast<const char*>(m_position), *size};
+			m_position += *size;
+			return value;
+		}
+
+		std::optional<std::string> ReadString() {
+			const auto value = ReadStringView();
+			if (!value) {
+				return std::nullopt;
+			}
+			return std::string{*value};
+		}
+
+		//! Split off the next `size` bytes into their own reader and skip past them.
+		std::optional<BinaryReader> ReadSubReader(size_t size) {
+			if (GetRemaining() < size) {
+				return std::nullopt;
+			}
+			auto subReader = BinaryReader{m_position, size};
+			m_position += size;
+			return subReader;
+		}
+
+		size_t GetRemaining() const { return static_cast<size_t>(m_end - m_position); }
+		bool IsAtEnd() const { return m_position == m_end; }
+
+	private:
+		const uint8_t* m_position;
+		const uint8_t* m_end;
+	};
+}
@@ -0,0 +1,114 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iZBase/common/common.h"
+
+IZ_PUSH_ALL_WARNINGS
+#include "gtest/gtest.h"
+IZ_POP_ALL_WARNINGS
+
+#include "Glass/Properties/Types/BinaryCodec.h"
+#include "Glass/Properties/Types/Builtins.h"
+#include "Glass/Properties/Types/OptionalProperty.h"
+#include "Glass/Properties/Types/VectorProperty.h"
+
+using namespace Glass;
+
+namespace {
+	template <typename T> std::optional<typename T::type> roundTrip(const typename T::type& value) {
+		BinaryWriter writer;
+		T::serializeBinary(value, writer);
+		const auto& buffer = writer.GetBuffer();
+		BinaryReader reader{buffer.data(), buffer.size()};
+		auto result = T::deserializeBinary(reader);
+		EXPECT_TRUE(reader.IsAtEnd());
+		return result;
+	}
+
+	struct NoBinaryPropertyType : PropertyType<NoBinaryPropertyType> {
+		using type = int32_t;
+		static constexpr auto name = "NoBinary";
+		static std::string serialize(int32_t) { return {}; }
+		static std::optional<int32_t> deserialize(const std::string&) { return 0; }
+	};
+
+	static_assert(HasBinarySerialization_v<IntPropertyType>);
+	static_assert(HasBinarySerialization_v<VectorProperty<FloatPropertyType>>);
+	static_assert(HasBinarySerialization_v<OptionalProperty<StringPropertyType>>);
+	static_assert(!HasBinarySerialization_v<NoBinaryPropertyType>);
+	static_assert(!HasBinarySerialization_v<VectorProperty<NoBinaryPropertyType>>);
+	static_assert(!HasBinarySerialization_v<OptionalProperty<NoBinaryPropertyType>>);
+}
+
+TEST(BinarySerialization, IntIsFixedWidth) {
+	BinaryWriter writer;
+	IntPropertyType::serializeBinary(-54, writer);
+	ASSERT_EQ(sizeof(int32_t), writer.GetSize());
+	ASSERT_EQ(-54, roundTrip<IntPropertyType>(-54));
+}
+
+TEST(BinarySerialization, Float) {
+	ASSERT_EQ(36.4f, roundTrip<FloatPropertyType>(36.4f));
+}
+
+TEST(BinarySerialization, Bool) {
+	ASSERT_EQ(true, roundTrip<BoolPropertyType>(true));
+	ASSERT_EQ(false, roundTrip<BoolPropertyType>(false));
+}
+
+TEST(BinarySerialization, String) {
+	ASSERT_EQ(std::string{"hello, world"}, roundTrip<StringPropertyType>("hello, world"));
+	ASSERT_EQ(std::string{}, roundTrip<StringPropertyType>(""));
+}
+
+TEST(BinarySerialization, Float4Dim) {
+	const auto single = roundTrip<Float4DimPropertyType>(Float4Dim{2.5f});
+	ASSERT_TRUE(single);
+	ASSERT_TRUE(boost::get<float>(&*single));
+	ASSERT_EQ(2.5f, boost::get<float>(*single));
+	const auto array = std::array<float, 4>{{1.f, 2.f, 3.f, 4.f}};
+	const auto roundTripped = roundTrip<Float4DimPropertyType>(Float4Dim{array});
+	ASSERT_TRUE(roundTripped);
+	ASSERT_TRUE((boost::get<std::array<float, 4>>(&*roundTripped)));
+	ASSERT_EQ(array, (boost::get<std::array<float, 4>>(*roundTripped)));
+}
+
+TEST(BinarySerialization, Vector) {
+	const auto value = vector<std::string>{"test string", "hello, world"};
+	ASSERT_EQ(value, roundTrip<VectorProperty<StringPropertyType>>(value));
+	ASSERT_EQ(vector<float>{}, roundTrip<VectorProperty<FloatPropertyType>>({}));
+}
+
+TEST(BinarySerialization, Optional) {
+	const auto value = vector<std::optional<int32_t>>{1, 2, std::nullopt, 4};
+	ASSERT_EQ(value, roundTrip<VectorProperty<OptionalProperty<IntPropertyType>>>(value));
+}
+
+TEST(BinarySerialization, TruncatedDataFails) {
+	BinaryWriter writer;
+	StringPropertyType::serializeBinary("truncated", writer);
+	const auto& buffer = writer.GetBuffer();
+	BinaryReader reader{buffer.data(), buffer.size() - 1};
+	ASSERT_FALSE(StringPropertyType::deserializeBinary(reader));
+}
+
+TEST(BinarySerialization, CorruptVectorSizeFails) {
+	BinaryWriter writer;
+	writer.WriteSize(1000000);
+	FloatPropertyType::serializeBinary(1.f, writer);
+	const auto& buffer = writer.GetBuffer();
+	BinaryReader reader{buffer.data(), buffer.size()};
+	ASSERT_FALSE(VectorProperty<FloatPropertyType>::deserializeBinary(reader));
+}
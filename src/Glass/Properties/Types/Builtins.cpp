@@ -20,6 +20,7 @@
 #include "iZBase/Util/VariantUtils.h"
 #include "Glass/Properties/RegisterPropertyType.h"
 #include "Glass/Properties/Types/Private/ToStringStripZeros.h"
+#include "Glass/Properties/Types/Private/parseSimpleNumber.h"
 #include "Glass/Properties/Types/Private/separateCommas.h"
 #include "Glass/Properties/Types/Private/separateSingleSpacedParams.h"
 
@@ -37,6 +38,16 @@ BoolPropertyType::deserialize(const std::string &serializedValue) {
   }
   return value.cast();
 }
+void BoolPropertyType::serializeBinary(bool value, BinaryWriter& writer) {
+	writer.Write(static_cast<uint8_t>(value ? 1 : 0));
+}
+std::optional<bool> BoolPropertyType::deserializeBinary(BinaryReader& reader) {
+	const auto value = reader.Read<uint8_t>();
+	if (!value || *value > 1) {
+		return std::nullopt;
+	}
+	return *value == 1;
+}
 GLASS_REGISTER_PROPERTY_TYPE(BoolPropertyType)
 
 std::string IntPropertyType::serialize(int32_t value) {
@@ -59,6 +70,23 @@ IntPropertyType::deserialize(const std::string &serializedValue) {
   }
   return value.cast();
 }
+void IntPropertyType::serializeBinary(int32_t value, BinaryWriter& writer) {
+	writer.Write(value);
+}
+std::optional<int32_t> IntPropertyType::deserializeBinary(BinaryReader& reader) {
+	return reader.Read<int32_t>();
+}
+void IntPropertyType::deserializeBatch(gsl::span<const std::string_view> serializedValues,
+                                       gsl::span<std::optional<int32_t>> values) {
+	auto value = values.begin();
+	for (const auto serializedValue : serializedValues) {
+		*value = parseSimpleInt(serializedValue);
+		if (!*value) {
+			*value = deserialize(std::string{serializedValue});
+		}
+		++value;
+	}
+}
 GLASS_REGISTER_PROPERTY_TYPE(IntPropertyType)
 
 std::string FloatPropertyType::serialize(float value) {
@@ -77,6 +105,29 @@ FloatPropertyType::deserialize(const std::string &serializedValue) {
   }
   return value.cast();
 }
+void FloatPropertyType::serializeBinary(float value, BinaryWriter& writer) {
+	writer.Write(value);
+}
+std::optional<float> FloatPropertyType::deserializeBinary(BinaryReader& reader) {
+	return reader.Read<float>();
+}
+void FloatPropertyType::deserializeBatch(gsl::span<const std::string_view> serializedValues,
+                                         gsl::span<std::optional<float>> values) {
+	auto value = values.begin();
+	for (const auto serializedValue : serializedValues) {
+		*value = parseSimpleFloat(serializedValue);
+		if (!*value) {
+			*value = deserialize(std::string{serializedValue});
+		}
+		++value;
+	}
+}
+void FloatPropertyType::toComponents(float value, gsl::span<float> components) {
+	components[0] = value;
+}
+float FloatPropertyType::fromComponents(gsl::span<const float> components, float, float) {
+	return components[0];
+}
 GLASS_REGISTER_PROPERTY_TYPE(FloatPropertyType)
 
 std::string Float4DimPropertyType::serialize(const type& value) {
@@ -110,6 +161,99 @@ Float4DimPropertyType::deserialize(const std::string &serializedValue) {
   }
   return std::nullopt;
 }
+namespace {
+	// Float4Dim is written as a one byte tag followed by either one or four floats
+	enum class Float4DimBinaryTag : uint8_t { Single = 0, Array = 1 };
+}
+void Float4DimPropertyType::serializeBinary(const type& value, BinaryWriter& writer) {
+	boost::apply_visitor(::Util::overload<void>(
+	                         [&](float single) {
+		                         writer.Write(Float4DimBinaryTag::Single);
+		                         writer.Write(single);
+	                         },
+	                         [&](const std::array<float, 4>& array) {
+		                         writer.Write(Float4DimBinaryTag::Array);
+		                         writer.Write(array);
+	                         }),
+	                     value);
+}
+std::optional<Float4Dim> Float4DimPropertyType::deserializeBinary(BinaryReader& reader) {
+	const auto tag = reader.Read<Float4DimBinaryTag>();
+	if (!tag) {
+		return std::nullopt;
+	}
+	switch (*tag) {
+	case Float4DimBinaryTag::Single:
+		if (const auto single = reader.Read<float>()) {
+			return Float4Dim{*single};
+		}
+		return std::nullopt;
+	case Float4DimBinaryTag::Array:
+		if (const auto array = reader.Read<std::array<float, 4>>()) {
+			return Float4Dim{*array};
+		}
+		return std::nullopt;
+	}
+	return std::nullopt;
+}
+namespace {
+	// Handles a single plain number or four plain numbers separated by single spaces, which
+	// deserialize treats the same way
+	std::optional<Float4Dim> deserializeSimpleFloat4Dim(std::string_view serializedValue) {
+		std::array<float, 4> array;
+		size_t count = 0;
+		while (count < array.size()) {
+			const auto separator = serializedValue.find(' ');
+			const auto component = parseSimpleFloat(serializedValue.substr(0, separator));
+			if (!component) {
+				return std::nullopt;
+			}
+			array[count++] = *component;
+			if (separator == std::string_view::npos) {
+				if (count == 1) {
+					return Float4Dim{array[0]};
+				}
+				if (count == array.size()) {
+					return Float4Dim{array};
+				}
+				return std::nullopt;
+			}
+			serializedValue.remove_prefix(separator + 1);
+		}
+		return std::nullopt;
+	}
+}
+void Float4DimPropertyType::deserializeBatch(gsl::span<const std::string_view> serializedValues,
+                                             gsl::span<std::optional<type>> values) {
+	auto value = values.begin();
+	for (const auto serializedValue : serializedValues) {
+		*value = deserializeSimpleFloat4Dim(serializedValue);
+		if (!*value) {
+			*value = deserialize(std::string{serializedValue});
+		}
+		++value;
+	}
+}
+void Float4DimPropertyType::toComponents(const type& value, gsl::span<float> components) {
+	boost::apply_visitor(::Util::overload<void>(
+	                         [&](float single) {
+		                         std::fill(components.begin(), components.end(), single);
+	                         },
+	                         [&](const std::array<float, 4>& array) {
+		                         std::copy(array.begin(), array.end(), components.begin());
+	                         }),
+	                     value);
+}
+Float4Dim Float4DimPropertyType::fromComponents(gsl::span<const float> components,
+                                                const type& from,
+                                                const type& to) {
+	if (boost::get<float>(&from) && boost::get<float>(&to)) {
+		return Float4Dim{components[0]};
+	}
+	std::array<float, 4> array;
+	std::copy(components.begin(), components.end(), array.begin());
+	return Float4Dim{array};
+}
 GLASS_REGISTER_PROPERTY_TYPE(Float4DimPropertyType)
 
 
@@ -120,4 +264,15 @@ std::optional<std::string>
 StringPropertyType::deserialize(const std::string &value) {
   return value;
 }
+bool StringPropertyType::deserializeInto(const std::string& serializedValue,
+                                         std::string& value) {
+	value.assign(serializedValue);
+	return true;
+}
+void StringPropertyType::serializeBinary(const std::string& value, BinaryWriter& writer) {
+	writer.WriteString(value);
+}
+std::optional<std::string> StringPropertyType::deserializeBinary(BinaryReader& reader) {
+	return reader.ReadString();
+}
 GLASS_REGISTER_PROPERTY_TYPE(StringPropertyType)
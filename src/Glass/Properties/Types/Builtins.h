@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include "gsl/span"
+
 #include "Glass/Float4Dim.h"
 #include "Glass/Properties/Types/PropertyType.h"
 //#include "Glass/Types.h"
@@ -25,6 +27,10 @@ namespace Glass {
 		static constexpr auto name = "Int";
 		static std::string serialize(int32_t value);
 		static std::optional<int32_t> deserialize(const std::string& serializedValue);
+		static void serializeBinary(int32_t value, BinaryWriter& writer);
+		static std::optional<int32_t> deserializeBinary(BinaryReader& reader);
+		static void deserializeBatch(gsl::span<const std::string_view> serializedValues,
+		                             gsl::span<std::optional<int32_t>> values);
 	};
 
 	struct FloatPropertyType : PropertyType<FloatPropertyType> {
@@ -32,6 +38,13 @@ namespace Glass {
 		static constexpr auto name = "Float";
 		static std::string serialize(float value);
 		static std::optional<float> deserialize(const std::string& serializedValue);
+		static void serializeBinary(float value, BinaryWriter& writer);
+		static std::optional<float> deserializeBinary(BinaryReader& reader);
+		static void deserializeBatch(gsl::span<const std::string_view> serializedValues,
+		                             gsl::span<std::optional<float>> values);
+		static constexpr size_t interpolationComponentCount = 1;
+		static void toComponents(float value, gsl::span<float> components);
+		static float fromComponents(gsl::span<const float> components, float from, float to);
 	};
 
         using Float4Dim = boost::variant<float, std::array<float, 4>>;
@@ -40,6 +53,17 @@ namespace Glass {
 		static constexpr auto name = "Float4Dim";
 		static std::string serialize(const type& value);
 		static std::optional<Float4Dim> deserialize(const std::string& serializedValue);
+		static void serializeBinary(const type& value, BinaryWriter& writer);
+		static std::optional<Float4Dim> deserializeBinary(BinaryReader& reader);
+		static void deserializeBatch(gsl::span<const std::string_view> serializedValues,
+		                             gsl::span<std::optional<type>> values);
+		//! Single values are interpolated as four equal components, and stay single if both
+		//! ends are
+		static constexpr size_t interpolationComponentCount = 4;
+		static void toComponents(const type& value, gsl::span<float> components);
+		static type fromComponents(gsl::span<const float> components,
+		                           const type& from,
+		                           const type& to);
 	};
 
 	struct BoolPropertyType : PropertyType<BoolPropertyType> {
@@ -47,6 +71,8 @@ namespace Glass {
 		static constexpr auto name = "Bool";
 		static std::string serialize(bool value);
 		static std::optional<bool> deserialize(const std::string& serializedValue);
+		static void serializeBinary(bool value, BinaryWriter& writer);
+		static std::optional<bool> deserializeBinary(BinaryReader& reader);
 	};
 
 	struct StringPropertyType : PropertyType<StringPropertyType> {
@@ -54,5 +80,8 @@ namespace Glass {
 		static constexpr auto name = "std::string";
 		static std::string serialize(std::string value);
 		static std::optional<std::string> deserialize(const std::string& serializedValue);
+		static bool deserializeInto(const std::string& serializedValue, std::string& value);
+		static void serializeBinary(const std::string& value, BinaryWriter& writer);
+		static std::optional<std::string> deserializeBinary(BinaryReader& reader);
 	};
 }
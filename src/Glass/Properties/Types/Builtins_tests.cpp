@@ -23,6 +23,24 @@ IZ_POP_ALL_WARNINGS
 
 using namespace Glass;
 
+namespace {
+	//! Check that T::deserializeBatch gives the same results as T::deserialize
+	template <typename T>
+	void expectBatchMatchesScalar(const vector<std::string>& serializedValues) {
+		const vector<std::string_view> views(serializedValues.begin(), serializedValues.end());
+		vector<std::optional<typename T::type>> values(views.size());
+		T::deserializeBatch(views, values);
+		for (size_t i = 0; i < serializedValues.size(); ++i) {
+			const auto expected = T::deserialize(serializedValues[i]);
+			EXPECT_EQ(static_cast<bool>(expected), static_cast<bool>(values[i]))
+			    << serializedValues[i];
+			if (expected && values[i]) {
+				EXPECT_TRUE(*expected == *values[i]) << serializedValues[i];
+			}
+		}
+	}
+}
+
 TEST(IntSerialization, IntIn) {
 	auto deserialized = IntPropertyType::deserialize("54");
 	ASSERT_TRUE(std::nullopt != deserialized);
@@ -84,6 +102,24 @@ TEST(IntSerialization, DeserializeFloat) {
 	ASSERT_FALSE(deserialized);
 }
 
+TEST(IntSerialization, Batch) {
+	static_assert(HasBatchDeserialization_v<IntPropertyType>);
+	static_assert(!HasBatchDeserialization_v<StringPropertyType>);
+	expectBatchMatchesScalar<IntPropertyType>({"54",
+	                                           "-54",
+	                                           "0",
+	                                           "-0",
+	                                           "123456789",
+	                                           "1234567890",
+	                                           "2147483647",
+	                                           "0x2a",
+	                                           "e1",
+	                                           "54.3",
+	                                           " 5",
+	                                           "abc",
+	                                           "-"});
+}
+
 TEST(FloatSerialization, FloatIn) {
 	auto deserialized = FloatPropertyType::deserialize("54.3");
 	ASSERT_TRUE(std::nullopt != deserialized);
@@ -130,6 +166,33 @@ TEST(FloatSerialization, String) {
 	ASSERT_FALSE(deserialized);
 }
 
+TEST(FloatSerialization, Batch) {
+	expectBatchMatchesScalar<FloatPropertyType>({"1",
+	                                             "1.5",
+	                                             "-0.25",
+	                                             "3.14159",
+	                                             "0.1",
+	                                             "16777216",
+	                                             "16777217",
+	                                             "123.456789",
+	                                             "0.0000000001",
+	                                             "0.00000000001",
+	                                             "1.5f",
+	                                             "1e3",
+	                                             ".5",
+	                                             "5.",
+	                                             " 2",
+	                                             "abc",
+	                                             "-"});
+
+	vector<std::string> sweep;
+	for (int i = -100000; i <= 100000; i += 37) {
+		sweep.push_back(std::to_string(i / 1000) + "." + std::to_string(std::abs(i % 1000)));
+		sweep.push_back(std::to_string(i) + "." + std::to_string(std::abs(i) % 7));
+	}
+	expectBatchMatchesScalar<FloatPropertyType>(sweep);
+}
+
 TEST(BoolSerialization, BoolIn) {
 	auto deserialized = BoolPropertyType::deserialize("true");
 	ASSERT_TRUE(std::nullopt != deserialized);
@@ -231,6 +294,19 @@ TEST(Float4DimPropertyTypeSerialization, TooBig) {
 	ASSERT_FALSE(deserialized);
 }
 
+TEST(Float4DimPropertyTypeSerialization, Batch) {
+	expectBatchMatchesScalar<Float4DimPropertyType>({"1",
+	                                                 "1.5",
+	                                                 "1 2 3 4",
+	                                                 "-1.25 0 2.5 -3",
+	                                                 "1 2 3",
+	                                                 "1 2 3 4 5",
+	                                                 "1,2,3,4",
+	                                                 "1, 2, 3, 4",
+	                                                 "1  2 3 4",
+	                                                 "1e3 2 3 4"});
+}
+
 TEST(StringSerialization, StringIn) {
 	const auto testString = "What # about $ a string \\ with \"SPACES\"?";
 	auto deserialized = StringPropertyType::deserialize(testString);
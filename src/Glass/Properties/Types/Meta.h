@@ -15,7 +15,18 @@
 
 #pragma once
 
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "gsl/span"
+
 namespace Glass {
+	class BinaryReader;
+	class BinaryWriter;
+
 	template <typename T, typename = std::void_t<>> struct IsPropertyType : std::false_type {};
 
 	template <typename T>
@@ -37,6 +48,100 @@ namespace Glass {
 
 	template <typename T> constexpr bool IsBetterEnumProperty_v = IsBetterEnumProperty<T>::value;
 
+	template <typename T, typename = std::void_t<>>
+	struct HasBinarySerialization : std::false_type {};
+
+	template <typename T>
+	struct HasBinarySerialization<
+	    T,
+	    std::void_t<decltype(T::serializeBinary(std::declval<const typename T::type&>(),
+	                                            std::declval<BinaryWriter&>())),
+	                decltype(T::deserializeBinary(std::declval<BinaryReader&>()))>>
+	    : std::is_convertible<decltype(T::deserializeBinary(std::declval<BinaryReader&>())),
+	                          std::optional<typename T::type>> {};
+
+	//! True if T provides the optional binary codec (see PropertyType)
+	template <typename T>
+	constexpr bool HasBinarySerialization_v = HasBinarySerialization<T>::value;
+
+	template <typename T, typename = std::void_t<>>
+	struct HasBatchDeserialization : std::false_type {};
+
+	template <typename T>
+	struct HasBatchDeserialization<
+	    T,
+	    std::void_t<decltype(T::deserializeBatch(
+	        std::declval<gsl::span<const std::string_view>>(),
+	        std::declval<gsl::span<std::optional<typename T::type>>>()))>> : std::true_type {};
+
+	//! True if T provides the optional batch deserializer (see PropertyType)
+	template <typename T>
+	constexpr bool HasBatchDeserialization_v = HasBatchDeserialization<T>::value;
+
+	template <typename T, typename Args, typename = std::void_t<>>
+	struct HasInPlaceDeserialization : std::false_type {};
+
+	template <typename T, typename... Args>
+	struct HasInPlaceDeserialization<
+	    T,
+	    std::tuple<Args...>,
+	    std::enable_if_t<std::is_same_v<decltype(T::deserializeInto(
+	                                         std::declval<const std::string&>(),
+	                                         std::declval<typename T::type&>(),
+	                                         std::declval<Args>()...)),
+	                                     bool>>> : std::true_type {};
+
+	//! True if T provides the optional in place deserializer (see PropertyType) taking the
+	//! extra arguments Args, which are the scratch space and context that T has
+	template <typename T, typename... Args>
+	constexpr bool HasInPlaceDeserialization_v =
+	    HasInPlaceDeserialization<T, std::tuple<Args...>>::value;
+
+	template <typename T, typename = std::void_t<>> struct HasInterpolation : std::false_type {};
+
+	template <typename T>
+	struct HasInterpolation<
+	    T,
+	    std::void_t<decltype(T::interpolationComponentCount),
+	                decltype(T::toComponents(std::declval<const typename T::type&>(),
+	                                         std::declval<gsl::span<float>>())),
+	                decltype(T::fromComponents(std::declval<gsl::span<const float>>(),
+	                                           std::declval<const typename T::type&>(),
+	                                           std::declval<const typename T::type&>()))>>
+	    : std::true_type {};
+
+	//! True if values of T can be interpolated (see PropertyType)
+	template <typename T> constexpr bool HasInterpolation_v = HasInterpolation<T>::value;
+
+	//! The number of floats values of T are interpolated as, or 0 if T can't be interpolated
+	template <typename T> constexpr size_t InterpolationComponentCount_v = [] {
+		if constexpr (HasInterpolation_v<T>) {
+			return size_t{T::interpolationComponentCount};
+		} else {
+			return size_t{0};
+		}
+	}();
+
+	template <typename T, typename = std::void_t<>>
+	struct IsEqualityComparable : std::false_type {};
+
+	template <typename T>
+	struct IsEqualityComparable<
+	    T,
+	    std::void_t<decltype(std::declval<const T&>() == std::declval<const T&>())>>
+	    : std::is_convertible<decltype(std::declval<const T&>() == std::declval<const T&>()),
+	                          bool> {};
+
+	// Containers declare operator== whether or not their elements have one
+	template <typename T, typename A>
+	struct IsEqualityComparable<std::vector<T, A>> : IsEqualityComparable<T> {};
+
+	template <typename T>
+	struct IsEqualityComparable<std::optional<T>> : IsEqualityComparable<T> {};
+
+	//! True if values of T can be compared with operator==
+	template <typename T> constexpr bool IsEqualityComparable_v = IsEqualityComparable<T>::value;
+
 	template <typename T>
 	constexpr bool IsLegacyPropertyType_v = !IsPropertyType_v<T> && !IsBetterEnumProperty_v<T>;
 }
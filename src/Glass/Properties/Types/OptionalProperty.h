@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <string_view>
+
 #include "Glass/Properties/Private/has_type.h"
 #include "Glass/Properties/Types/PropertyType.h"
 #include "Glass/Properties/Private/getName.h"
@@ -22,6 +24,8 @@
 namespace Glass {
 	namespace Private {
 		static constexpr auto NulloptString = "std::nullopt";
+		//! OptionalProperty<T>::name is this followed by the name of T
+		constexpr std::string_view OptionalPropertyNamePrefix = "Optional: ";
 
 		template <typename T,
 		          bool = has_static_member_data_is_keypath<T, const bool>::value,
@@ -44,12 +48,16 @@ namespace Glass {
 		                 has_type_allowed_keypath_types<T>::value>
 		struct OptionalPropertyBase : T {
 			using type = std::optional<typename T::type>;
-			static std::string name() { return std::string{"Optional: "} + getName<T>(); }
+			static std::string name() {
+				return std::string{OptionalPropertyNamePrefix} + getName<T>();
+			}
 		};
 
 		template <typename T> struct OptionalPropertyBase<T, true> : T {
 			using type = std::optional<typename T::type>;
-			static std::string name() { return std::string{"Optional: "} + getName<T>(); }
+			static std::string name() {
+				return std::string{OptionalPropertyNamePrefix} + getName<T>();
+			}
 
 			using allowed_keypath_types = typename AllowedKeypathTypes<T>::type;
 		};
@@ -94,6 +102,32 @@ namespace Glass {
 			}
 			return std::nullopt;
 		}
+
+		//! Written as a one byte flag, followed by the wrapped value if there is one
+		template <typename U = T>
+		static auto serializeBinary(const type& value, BinaryWriter& writer)
+		    -> std::enable_if_t<HasBinarySerialization_v<U>> {
+			writer.Write(static_cast<uint8_t>(value ? 1 : 0));
+			if (value) {
+				U::serializeBinary(*value, writer);
+			}
+		}
+
+		template <typename U = T>
+		static auto deserializeBinary(BinaryReader& reader)
+		    -> std::enable_if_t<HasBinarySerialization_v<U>, std::optional<type>> {
+			const auto hasValue = reader.Read<uint8_t>();
+			if (!hasValue || *hasValue > 1) {
+				return std::nullopt;
+			}
+			if (*hasValue == 0) {
+				return type{};
+			}
+			if (auto deserialized = U::deserializeBinary(reader)) {
+				return std::optional<type>{type{std::move(*deserialized)}};
+			}
+			return std::nullopt;
+		}
 	};
 
 	template <typename T>
@@ -127,7 +161,8 @@ namespace Glass {
 			if (serializedValue == std::string{Private::NulloptString}) {
 				return Deserialized{};
 			} else if (auto deserialized = T::deserialize(serializedValue)) {
-				return Deserialized{(*deserialized).scratchSpace, ((*deserialized).value)};
+				return Deserialized{scratch_type{std::move(deserialized->scratchSpace)},
+				                    type{std::move(deserialized->value)}};
 			}
 			return std::nullopt;
 		}
@@ -140,7 +175,8 @@ namespace Glass {
 			if (serializedValue == std::string{Private::NulloptString}) {
 				return Deserialized{};
 			} else if (auto deserialized = T::deserialize(serializedValue, context)) {
-				return Deserialized{(*deserialized).scratchSpace, ((*deserialized).value)};
+				return Deserialized{scratch_type{std::move(deserialized->scratchSpace)},
+				                    type{std::move(deserialized->value)}};
 			}
 			return std::nullopt;
 		}
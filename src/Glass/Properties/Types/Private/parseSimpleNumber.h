@@ -0,0 +1,85 @@
+// Copyright 2017-2021 iZotope, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace Glass {
+	namespace Private {
+		//! Parse a plain decimal integer, like "-123", of at most nine digits.  Returns
+		//! std::nullopt for anything else, including integers written in other forms, so callers
+		//! must fall back to a complete parser.
+		inline std::optional<int32_t> parseSimpleInt(std::string_view text) {
+			const bool isNegative = !text.empty() && text.front() == '-';
+			if (isNegative) {
+				text.remove_prefix(1);
+			}
+			if (text.empty() || text.size() > 9) {
+				return std::nullopt;
+			}
+			int32_t value = 0;
+			for (const char c : text) {
+				if (c < '0' || c > '9') {
+					return std::nullopt;
+				}
+				value = value * 10 + (c - '0');
+			}
+			return isNegative ? -value : value;
+		}
+
+		//! Parse a plain decimal number, like "-12.5", whose digits fit in the 24 bit
+		//! significand of a float and that has at most ten fractional digits.  Both the digits
+		//! and the power of ten are then exact floats, so one correctly rounded division gives
+		//! the same result as strtof.  Returns std::nullopt for anything else, so callers must
+		//! fall back to a complete parser.
+		inline std::optional<float> parseSimpleFloat(std::string_view text) {
+			constexpr float PowersOfTen[] = {
+			    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+			constexpr uint32_t MaxExactDigits = uint32_t{1} << 24;
+
+			const bool isNegative = !text.empty() && text.front() == '-';
+			if (isNegative) {
+				text.remove_prefix(1);
+			}
+			uint32_t digits = 0;
+			size_t integerDigitCount = 0;
+			size_t fractionalDigitCount = 0;
+			bool isInFraction = false;
+			for (const char c : text) {
+				if (c == '.' && !isInFraction) {
+					isInFraction = true;
+					continue;
+				}
+				if (c < '0' || c > '9') {
+					return std::nullopt;
+				}
+				digits = digits * 10 + static_cast<uint32_t>(c - '0');
+				if (digits > MaxExactDigits) {
+					return std::nullopt;
+				}
+				++(isInFraction ? fractionalDigitCount : integerDigitCount);
+			}
+			if (integerDigitCount == 0 || (isInFraction && fractionalDigitCount == 0) ||
+			    fractionalDigitCount >= std::size(PowersOfTen)) {
+				return std::nullopt;
+			}
+			const auto value = static_cast<float>(digits) / PowersOfTen[fractionalDigitCount];
+			return isNegative ? -value : value;
+		}
+	}
+}
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include "Glass/Properties/Types/BinaryCodec.h"
 #include "Glass/Properties/Types/Meta.h"
 #include "Glass/Properties/Types/ScratchSpaceAndValue.h"
 
@@ -100,6 +101,70 @@ namespace Glass {
 	//!   EnumParam* but does NOT support keypaths to EnumOrFloatParam.  To handle this, instead add
 	//!   a member type named `allowed_keypath_types`, which should be a std::tuple containing each
 	//!   allowed keypath type.
+	//!
+	//! # Binary serialization
+	//!
+	//!   Text is the authoring format, but types can also opt in to a compact binary encoding that
+	//!   is used for shipping and caching (see SimplePropertyHolder::SerializeBinary).  To do so,
+	//!   define:
+	//!
+	//!   static void serializeBinary(const type& value, BinaryWriter& writer)
+	//!   static std::optional<type> deserializeBinary(BinaryReader& reader)
+	//!
+	//!   Fixed width types should write themselves with BinaryWriter::Write, and variable length
+	//!   types should be length prefixed so that readers can tell where they end.  Binary codecs
+	//!   are not supported for types with a `scratch_type` or a `context_type`, since neither
+	//!   the scratch space nor the context can be recovered from the encoded value.
+	//!
+	//! # Batch deserialization
+	//!
+	//!   Layouts often contain long runs of values of the same type.  Types can opt in to
+	//!   deserializing a whole run at once, with one call instead of one per value, by defining:
+	//!
+	//!   static void deserializeBatch(gsl::span<const std::string_view> serializedValues,
+	//!                                gsl::span<std::optional<type>> values)
+	//!
+	//!   `values` has the same size as `serializedValues`, and each value should be set to what
+	//!   `deserialize` would return for the serialized value at the same index.  Like binary
+	//!   codecs, batch deserializers are not supported for types with a `scratch_type` or a
+	//!   `context_type`.  See GlobalPropertyData::deserializeBatch.
+	//!
+	//! # In place deserialization
+	//!
+	//!   `deserialize` returns a new value, so deserializing a property again allocates new
+	//!   storage for it even when the old value's would do.  Types with heap storage, such as
+	//!   strings and vectors, can opt in to deserializing into the existing value by defining:
+	//!
+	//!   static bool deserializeInto(const std::string& serializedValue, type& value)
+	//!
+	//!   This should set `value` to what `deserialize` would return, reusing its storage, and
+	//!   return false, leaving `value` as it was, if deserialization fails.  Types with a
+	//!   `scratch_type` also take the existing scratch space, which should likewise be set to
+	//!   the one `deserialize` would return, and types with a `context_type` take the context
+	//!   last, as `deserialize` does:
+	//!
+	//!   static bool deserializeInto(const std::string& serializedValue,
+	//!                               type& value,
+	//!                               scratch_type& scratch,
+	//!                               const context_type* context)
+	//!
+	//!   For types with a scratch space, the in place deserializer is only used when there is an
+	//!   existing scratch space to reuse.  See GlobalPropertyData::DeserializeInto.
+	//!
+	//! # Interpolation
+	//!
+	//!   Types whose values can be blended, such as sizes and colors, can opt in to being
+	//!   interpolated when morphing between snapshots (see PropertyMorph).  A value is
+	//!   interpolated as a fixed number of floats, each of which is blended linearly:
+	//!
+	//!   static constexpr size_t interpolationComponentCount = N;
+	//!   static void toComponents(const type& value, gsl::span<float> components)
+	//!   static type fromComponents(gsl::span<const float> components,
+	//!                              const type& from,
+	//!                              const type& to)
+	//!
+	//!   `components` has N elements.  `fromComponents` is given the two values being blended,
+	//!   for types whose values have a shape that the components don't capture.
 	template <typename T, typename = void> struct PropertyType;
 
 	template <typename T> struct PropertyType<T, std::enable_if_t<!IsBetterEnumProperty_v<T>>> {
@@ -118,5 +183,21 @@ namespace Glass {
 			}
 			return *maybeValue;
 		}
+
+		using integral_type = decltype(std::declval<T>()._to_integral());
+		static void serializeBinary(const T& value, BinaryWriter& writer) {
+			writer.Write(value._to_integral());
+		}
+		static std::optional<type> deserializeBinary(BinaryReader& reader) {
+			const auto integral = reader.Read<integral_type>();
+			if (!integral) {
+				return std::nullopt;
+			}
+			const auto maybeValue = T::_from_integral_nothrow(*integral);
+			if (!maybeValue) {
+				return std::nullopt;
+			}
+			return *maybeValue;
+		}
 	};
 }
@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "Glass/Properties/Types/PropertyType.h"
 #include "Glass/Properties/Private/getName.h"
 
@@ -71,5 +73,64 @@ namespace Glass {
 
 			return returnVector;
 		}
+
+		//! Deserialize into `value`, keeping its buffer.  Each element is assigned over the old
+		//! one at its index, and `value` is then resized.  The old elements that are overwritten
+		//! are kept aside until every element has been deserialized, so `value` is put back as
+		//! it was if one fails.
+		static bool deserializeInto(const std::string& serializedValue, type& value) {
+			const vector<std::string> vectorResults =
+			    Private::parseSerializedVectorProperty(serializedValue);
+			const auto oldSize = value.size();
+			const auto newSize = vectorResults.size();
+			type overwritten;
+			overwritten.reserve(std::min(oldSize, newSize));
+			for (size_t i = 0; i < newSize; ++i) {
+				auto item = T::deserialize(vectorResults[i]);
+				if (!item) {
+					value.erase(value.begin() + static_cast<ptrdiff_t>(std::min(oldSize, i)),
+					            value.end());
+					std::move(overwritten.begin(), overwritten.end(), value.begin());
+					return false;
+				}
+				if (i < oldSize) {
+					overwritten.push_back(std::move(value[i]));
+					value[i] = std::move(*item);
+				} else {
+					value.push_back(std::move(*item));
+				}
+			}
+			value.erase(value.begin() + static_cast<ptrdiff_t>(newSize), value.end());
+			return true;
+		}
+
+		template <typename U = T>
+		static auto serializeBinary(const type& value, BinaryWriter& writer)
+		    -> std::enable_if_t<HasBinarySerialization_v<U>> {
+			writer.WriteSize(value.size());
+			for (const auto& item : value) {
+				U::serializeBinary(item, writer);
+			}
+		}
+
+		template <typename U = T>
+		static auto deserializeBinary(BinaryReader& reader)
+		    -> std::enable_if_t<HasBinarySerialization_v<U>, std::optional<type>> {
+			const auto size = reader.ReadSize();
+			if (!size) {
+				return std::nullopt;
+			}
+			type returnVector;
+			// Every element takes at least one byte, so don't trust sizes larger than the data
+			returnVector.reserve(std::min(*size, reader.GetRemaining()));
+			for (size_t i = 0; i < *size; ++i) {
+				auto item = U::deserializeBinary(reader);
+				if (!item) {
+					return std::nullopt;
+				}
+				returnVector.push_back(std::move(*item));
+			}
+			return returnVector;
+		}
 	};
 }
@@ -71,3 +71,21 @@ TEST(VectorSerialization, DeserializeOptionalIntVector) {
 	ASSERT_TRUE(deserialized);
 	ASSERT_EQ(*deserialized, (vector<std::optional<int>>{1, 2, std::nullopt, 4}));
 }
+
+TEST(VectorSerialization, DeserializeIntoReusesBuffer) {
+	auto value = vector<float>{1.f, 2.f};
+	const auto* buffer = value.data();
+	ASSERT_TRUE(VectorProperty<FloatPropertyType>::deserializeInto("vector(3, 4)", value));
+	ASSERT_EQ(value, (vector<float>{3.f, 4.f}));
+	ASSERT_EQ(buffer, value.data());
+	ASSERT_TRUE(VectorProperty<FloatPropertyType>::deserializeInto("vector(5)", value));
+	ASSERT_EQ(value, (vector<float>{5.f}));
+	ASSERT_EQ(buffer, value.data());
+
+	ASSERT_FALSE(VectorProperty<FloatPropertyType>::deserializeInto("vector(7, pizza)", value));
+	ASSERT_EQ(value, (vector<float>{5.f}));
+	ASSERT_FALSE(VectorProperty<FloatPropertyType>::deserializeInto("vector(7, 8, pizza)", value));
+	ASSERT_EQ(value, (vector<float>{5.f}));
+	ASSERT_TRUE(VectorProperty<FloatPropertyType>::deserializeInto("vector(7, 8, 9)", value));
+	ASSERT_EQ(value, (vector<float>{7.f, 8.f, 9.f}));
+}